@@ -0,0 +1,213 @@
+#ifndef COLUMNS_H
+#define COLUMNS_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace fw21 {
+
+// Storage precision of the meteorological columns of a FW21Timeseries
+enum class Precision : std::uint8_t {
+    // 8 bytes per value, exact
+    Float64 = 0,
+    // 4 bytes per value, ~7 significant digits
+    Float32 = 1,
+    // 2 bytes per value, fixed point with a per-column resolution
+    Scaled16 = 2
+};
+
+// A typed view of one column inside a FW21Timeseries arena. Columns are
+// filled and resized by the owning timeseries only; everybody else gets
+// vector-like read access.
+template <typename T>
+class Column {
+    T* m_data = nullptr;
+    std::ptrdiff_t m_size = 0;
+
+    friend struct FW21Timeseries;
+
+   public:
+    Column() = default;
+    Column(const Column&) = delete;
+    Column& operator=(const Column&) = delete;
+    Column(Column&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)),
+          m_size(std::exchange(other.m_size, 0)) {}
+    Column& operator=(Column&& other) noexcept {
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        return *this;
+    }
+
+    T& operator[](std::ptrdiff_t idx) { return m_data[idx]; }
+    const T& operator[](std::ptrdiff_t idx) const { return m_data[idx]; }
+    T* data() { return m_data; }
+    const T* data() const { return m_data; }
+    std::size_t size() const { return static_cast<std::size_t>(m_size); }
+    bool empty() const { return m_size == 0; }
+
+    T* begin() { return m_data; }
+    T* end() { return m_data + m_size; }
+    const T* begin() const { return m_data; }
+    const T* end() const { return m_data + m_size; }
+};
+
+// A meteorological column stored at a selectable precision. Values are
+// always read and written as doubles; missing values are NaN at every
+// precision.
+class MetColumn {
+    void* m_data = nullptr;
+    std::ptrdiff_t m_size = 0;
+    Precision m_precision = Precision::Float64;
+    // Scaled16 values are stored as round(value * divisor)
+    double m_divisor = 1.0;
+
+    friend struct FW21Timeseries;
+
+   public:
+    // Scaled16 sentinel for NaN and out of range values
+    static constexpr std::int16_t missing =
+        std::numeric_limits<std::int16_t>::min();
+
+    static std::size_t element_size(Precision precision) {
+        switch (precision) {
+            case Precision::Float32:
+                return sizeof(float);
+            case Precision::Scaled16:
+                return sizeof(std::int16_t);
+            default:
+                return sizeof(double);
+        }
+    }
+
+    MetColumn() = default;
+    MetColumn(const MetColumn&) = delete;
+    MetColumn& operator=(const MetColumn&) = delete;
+    MetColumn(MetColumn&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)),
+          m_size(std::exchange(other.m_size, 0)),
+          m_precision(other.m_precision),
+          m_divisor(other.m_divisor) {}
+    MetColumn& operator=(MetColumn&& other) noexcept {
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_precision = other.m_precision;
+        m_divisor = other.m_divisor;
+        return *this;
+    }
+
+    double operator[](std::ptrdiff_t idx) const {
+        switch (m_precision) {
+            case Precision::Float32:
+                return static_cast<const float*>(m_data)[idx];
+            case Precision::Scaled16: {
+                const std::int16_t raw =
+                    static_cast<const std::int16_t*>(m_data)[idx];
+                return (raw == missing) ? std::nan("") : raw / m_divisor;
+            }
+            default:
+                return static_cast<const double*>(m_data)[idx];
+        }
+    }
+
+    void set(std::ptrdiff_t idx, double value) {
+        switch (m_precision) {
+            case Precision::Float32:
+                static_cast<float*>(m_data)[idx] = static_cast<float>(value);
+                break;
+            case Precision::Scaled16: {
+                const double scaled = std::round(value * m_divisor);
+                // NaN fails both comparisons and ends up as missing too
+                static_cast<std::int16_t*>(m_data)[idx] =
+                    ((scaled > missing) &&
+                     (scaled <= std::numeric_limits<std::int16_t>::max()))
+                        ? static_cast<std::int16_t>(scaled)
+                        : missing;
+                break;
+            }
+            default:
+                static_cast<double*>(m_data)[idx] = value;
+                break;
+        }
+    }
+
+    // Decode rows [start, start + count) into out. The precision switch
+    // is hoisted out of the loops so each one vectorizes.
+    void decode(std::ptrdiff_t start, std::ptrdiff_t count,
+                double* out) const {
+        switch (m_precision) {
+            case Precision::Float32: {
+                const float* values = static_cast<const float*>(m_data);
+                for (std::ptrdiff_t idx = 0; idx < count; ++idx) {
+                    out[idx] = values[start + idx];
+                }
+                break;
+            }
+            case Precision::Scaled16: {
+                const std::int16_t* values =
+                    static_cast<const std::int16_t*>(m_data);
+                const double nan = std::numeric_limits<double>::quiet_NaN();
+                for (std::ptrdiff_t idx = 0; idx < count; ++idx) {
+                    const std::int16_t raw = values[start + idx];
+                    out[idx] = (raw == missing) ? nan : raw / m_divisor;
+                }
+                break;
+            }
+            default: {
+                const double* values = static_cast<const double*>(m_data);
+                for (std::ptrdiff_t idx = 0; idx < count; ++idx) {
+                    out[idx] = values[start + idx];
+                }
+                break;
+            }
+        }
+    }
+
+    // Store values into rows [start, start + count), the bulk version of
+    // set()
+    void encode(std::ptrdiff_t start, std::ptrdiff_t count,
+                const double* values) {
+        switch (m_precision) {
+            case Precision::Float32: {
+                float* out = static_cast<float*>(m_data) + start;
+                for (std::ptrdiff_t idx = 0; idx < count; ++idx) {
+                    out[idx] = static_cast<float>(values[idx]);
+                }
+                break;
+            }
+            case Precision::Scaled16:
+                for (std::ptrdiff_t idx = 0; idx < count; ++idx) {
+                    set(start + idx, values[idx]);
+                }
+                break;
+            default: {
+                double* out = static_cast<double*>(m_data) + start;
+                for (std::ptrdiff_t idx = 0; idx < count; ++idx) {
+                    out[idx] = values[idx];
+                }
+                break;
+            }
+        }
+    }
+
+    // The values as a contiguous double array when stored at Float64
+    // precision, nullptr otherwise
+    const double* data() const {
+        return (m_precision == Precision::Float64)
+                   ? static_cast<const double*>(m_data)
+                   : nullptr;
+    }
+    const void* raw() const { return m_data; }
+    void* raw() { return m_data; }
+    Precision precision() const { return m_precision; }
+    double divisor() const { return m_divisor; }
+    std::size_t size() const { return static_cast<std::size_t>(m_size); }
+    bool empty() const { return m_size == 0; }
+};
+
+}  // namespace fw21
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef FW21_CACHE_H
+#define FW21_CACHE_H
+
+#include <NFDRSGUI/FW21Decoder.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace fw21 {
+
+// On-disk binary cache of a decoded FW21Timeseries.
+//
+// Layout (native byte order, every block 64-byte aligned):
+//   CacheHeader
+//   CacheColumn[n_columns]   column directory
+//   column blocks            raw column data, in directory order
+//
+// The header records the size and modification time of the FW21 file
+// the cache was built from, so a cache is only used while it matches
+// its source.
+namespace cache {
+
+inline constexpr char magic[8] = {'N', 'F', 'D', 'R', 'S', 'F', 'W', '1'};
+inline constexpr std::uint32_t version = 4;
+inline constexpr std::uint32_t byte_order_mark = 0x01020304;
+inline constexpr std::size_t block_alignment = 64;
+
+enum ColumnType : std::uint32_t {
+    COLUMN_FLOAT64 = 0,
+    COLUMN_INT32 = 1,
+    COLUMN_FLOAT32 = 2,
+    // fixed point, see MetColumn::divisor
+    COLUMN_SCALED16 = 3
+};
+
+enum ColumnId : std::uint32_t {
+    DATE_TIME = 0,
+    AIR_TEMPERATURE,
+    RELATIVE_HUMIDITY,
+    PRECIPITATION,
+    WIND_SPEED,
+    WIND_DIRECTION,
+    SOLAR_RADIATION,
+    GUST_SPEED,
+    GUST_DIRECTION,
+    SNOW_FLAG,
+    SPC_CAT,
+    N_COLUMNS
+};
+
+struct alignas(block_alignment) CacheHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order_mark;
+    std::int64_t n_rows;
+    std::uint64_t source_size;
+    std::int64_t source_mtime;
+    // FW21Timeseries::consumed_bytes of the decoded source, which stops
+    // short of source_size when the last row is unterminated
+    std::uint64_t consumed_bytes;
+    std::uint32_t n_columns;
+    // fw21::Precision of the meteorological columns
+    std::uint32_t met_precision;
+    // FW21Timeseries::partial_last_row, 0 or 1
+    std::uint32_t partial_last_row;
+    // NUL terminated, truncated if longer
+    char station_id[64];
+};
+
+struct CacheColumn {
+    std::uint32_t id;
+    std::uint32_t type;
+    std::uint64_t offset;
+    std::uint64_t n_bytes;
+};
+
+}  // namespace cache
+
+// Default location of the cache for a FW21 file
+std::string fw21_cache_path(const std::string& source_path);
+
+// Write ts_data to cache_path, stamped with the current size and
+// modification time of source_path. The file is written to a temporary
+// name and renamed into place, so readers never see a partial cache.
+bool write_fw21_cache(const FW21Timeseries& ts_data,
+                      const std::string& cache_path,
+                      const std::string& source_path);
+
+// Map cache_path and copy its column blocks into a new timeseries.
+// Returns nullptr if the cache is missing, corrupt, from another
+// version, stored at a precision other than met_precision, or stale
+// with respect to source_path.
+std::unique_ptr<FW21Timeseries> read_fw21_cache(
+    const std::string& cache_path, const std::string& source_path,
+    Precision met_precision = Precision::Float64);
+
+}  // namespace fw21
+
+#endif
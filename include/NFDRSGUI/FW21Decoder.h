@@ -1,62 +1,195 @@
 #ifndef FW21DECODER_H
 #define FW21DECODER_H
 
+#include <NFDRSGUI/Columns.h>
+#include <NFDRSGUI/ModelInputs.h>
+
 #include <cstddef>
+#include <cstdint>
 #include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <string_view>
 #include <vector>
 
 namespace fw21 {
 
+// Locale and timezone independent decoder for the ISO-8601 timestamps
+// in FW21 files (yyyy-mm-ddThh:mm:ss[+-]hh:mm). Each instance caches the
+// last seen day and UTC offset, so consecutive hourly rows cost only a
+// few integer operations. Instances are not shared between threads;
+// give each thread or decode pass its own.
+class DateTimeDecoder {
+    char m_day[10] = {};
+    char m_offset[6] = {};
+    std::size_t m_offset_size = ~std::size_t(0);
+    std::int64_t m_day_seconds = 0;
+    std::int64_t m_offset_seconds = 0;
+    bool m_day_valid = false;
+
+   public:
+    // Returns false if datetime_str is not a valid timestamp, in which
+    // case unix_time is left untouched.
+    bool decode(std::string_view datetime_str, std::time_t& unix_time);
+};
+
+// Convenience wrapper around a thread_local DateTimeDecoder. Returns -1
+// on malformed input.
+std::time_t parse_datetime_to_unix_time(std::string_view datetime_str);
+
+// Calendar fields of a unix time in UTC
+struct CivilTime {
+    int year;
+    int month;
+    int day;
+    int hour;
+    int minute;
+    int second;
+};
+
+// Integer only, thread safe replacement for gmtime. Fractional seconds
+// are truncated towards the past.
+CivilTime civil_from_unix_time(double unix_time);
+
+// One decoded FW21 row, used to move rows in and out of a timeseries
+struct FW21Row {
+    double date_time;
+    double air_temperature;
+    double relative_humidity;
+    double precipitation;
+    double wind_speed;
+    double wind_direction;
+    double solar_radiation;
+    double gust_speed;
+    double gust_direction;
+    int snow_flag;
+    int spc_cat = 0;
+};
+
+// A run of consecutive rows [start, end) sharing the same nonzero fire
+// weather category
+struct FireCatSpan {
+    std::ptrdiff_t start;
+    std::ptrdiff_t end;
+    int category;
+};
+
+// Columnar storage for a station's hourly observations. All columns live
+// in a single cache-line aligned allocation (the arena) that grows
+// geometrically as rows are pushed. The meteorological columns can be
+// held at reduced precision to save memory; they read back as doubles
+// regardless.
 struct FW21Timeseries {
-    // constructor
-    FW21Timeseries(std::ptrdiff_t NTIMES) : NT(NTIMES) {
-        date_time.reserve(NT);
-        air_temperature.reserve(NT);
-        relative_humidity.reserve(NT);
-        precipitation.reserve(NT);
-        wind_speed.reserve(NT);
-        wind_direction.reserve(NT);
-        solar_radiation.reserve(NT);
-        gust_speed.reserve(NT);
-        gust_direction.reserve(NT);
-        snow_flag.reserve(NT);
-        spc_cat.reserve(NT);
-    }
-
-    // move constructor
-    FW21Timeseries(FW21Timeseries&& other) noexcept : NT(other.NT) {
-        date_time = std::move(other.date_time);
-        air_temperature = std::move(other.air_temperature);
-        relative_humidity = std::move(other.relative_humidity);
-        precipitation = std::move(other.precipitation);
-        wind_speed = std::move(other.wind_speed);
-        wind_direction = std::move(other.wind_direction);
-        solar_radiation = std::move(other.solar_radiation);
-        gust_speed = std::move(other.gust_speed);
-        gust_direction = std::move(other.gust_direction);
-        snow_flag = std::move(other.snow_flag);
-        spc_cat = std::move(other.spc_cat);
-    }
-
-    const std::ptrdiff_t NT;
-
-    std::vector<double> date_time;
-    std::vector<double> air_temperature;
-    std::vector<double> relative_humidity;
-    std::vector<double> precipitation;
-    std::vector<double> wind_speed;
-    std::vector<double> wind_direction;
-    std::vector<double> solar_radiation;
-    std::vector<double> gust_speed;
-    std::vector<double> gust_direction;
-    std::vector<int> snow_flag;
+    // Alignment of the arena and of every column inside it
+    static constexpr std::size_t column_alignment = 64;
+
+    // constructor; reserves room for NTIMES rows
+    explicit FW21Timeseries(std::ptrdiff_t NTIMES = 0,
+                            Precision met_precision = Precision::Float64);
+
+    FW21Timeseries(FW21Timeseries&& other) noexcept = default;
+    FW21Timeseries& operator=(FW21Timeseries&& other) noexcept = default;
+
+    // Number of rows
+    std::ptrdiff_t NT = 0;
+    // Bytes of the source buffer decoded so far, up to and including
+    // its last newline; append_fw21 resumes from here
+    std::size_t consumed_bytes = 0;
+    // The source's header line was complete and has been skipped. Until
+    // then append_fw21 skips it first, so it is never read as a row.
+    bool header_consumed = false;
+    // The last row was decoded from an unterminated line past
+    // consumed_bytes, such as a row still being written. append_fw21
+    // replaces it once the line is complete.
+    bool partial_last_row = false;
+    // Station identifier from the first column of the first row
+    std::string station_id;
+
+    Column<double> date_time;
+    MetColumn air_temperature;
+    MetColumn relative_humidity;
+    MetColumn precipitation;
+    MetColumn wind_speed;
+    MetColumn wind_direction;
+    MetColumn solar_radiation;
+    MetColumn gust_speed;
+    MetColumn gust_direction;
+    Column<int> snow_flag;
 
     // derived stuff
-    std::vector<int> spc_cat;
+    Column<int> spc_cat;
+    // spc_cat run-length encoded, in row order
+    std::vector<FireCatSpan> fire_cat_spans;
+
+    Precision met_precision() const { return m_met_precision; }
+    std::ptrdiff_t capacity() const { return m_capacity; }
+    // Bytes held by the arena
+    std::size_t memory_usage() const;
+
+    // Grow the arena to hold at least n_rows rows
+    void reserve(std::ptrdiff_t n_rows);
+    // Set the number of rows to n_rows. New rows are uninitialized and
+    // must be written before they are read.
+    void resize(std::ptrdiff_t n_rows);
+    void push_row(const FW21Row& row);
+    FW21Row row(std::ptrdiff_t idx) const;
+    // Append every row of other, copying whole column blocks when both
+    // use the same precision
+    void append(const FW21Timeseries& other);
+
+    static FW21Timeseries decode_fw21(
+        std::string_view data_buffer,
+        Precision met_precision = Precision::Float64);
+    // Split data_buffer at line boundaries and decode the pieces on up
+    // to n_threads threads of the shared Scheduler (0 means the whole
+    // pool), then merge them. The
+    // result is identical to decode_fw21; small buffers are simply
+    // decoded serially.
+    static FW21Timeseries decode_fw21_parallel(
+        std::string_view data_buffer, unsigned n_threads = 0,
+        Precision met_precision = Precision::Float64);
+    // Decode only the rows of data_buffer (the whole, grown source
+    // file) past consumed_bytes, extending every column and spc_cat.
+    // Only newline terminated rows are consumed, so a row that is still
+    // being written is picked up by the next call. A partial_last_row is
+    // dropped and decoded again, along with the derived model inputs.
+    // Returns the number of rows added, counting a replaced row.
+    std::ptrdiff_t append_fw21(std::string_view data_buffer);
+    // Record that every row of data_buffer (the whole source file) has
+    // been decoded, setting consumed_bytes, header_consumed and
+    // partial_last_row
+    void set_consumed(std::string_view data_buffer);
+    // Compute the fire weather categories from row start onward and
+    // bring fire_cat_spans up to date
+    void calc_fire_cat(std::ptrdiff_t start = 0);
+    // Rebuild fire_cat_spans from the current spc_cat, such as one read
+    // back from a cache
+    void calc_fire_cat_spans();
+
+    // The rows converted for the fuel models, built on first use and
+    // extended on later calls after rows were appended. Thread safe, but
+    // must not be called while rows are being added; the reference stays
+    // valid until then.
+    const ModelInputs& model_inputs() const;
+
+   private:
+    struct ArenaDeleter {
+        void operator()(std::byte* arena) const;
+    };
+
+    struct InputsCache {
+        std::mutex mutex;
+        ModelInputs inputs;
+    };
+
+    std::unique_ptr<std::byte[], ArenaDeleter> m_arena;
+    std::ptrdiff_t m_capacity = 0;
+    Precision m_met_precision = Precision::Float64;
+    std::unique_ptr<InputsCache> m_inputs_cache =
+        std::make_unique<InputsCache>();
 
-    static FW21Timeseries decode_fw21(std::string_view data_buffer);
-    void calc_fire_cat();
+    void set_size(std::ptrdiff_t n_rows);
 };
 
 }  // namespace fw21
@@ -0,0 +1,55 @@
+#ifndef FILE_LOADER_H
+#define FILE_LOADER_H
+
+#include <NFDRSGUI/FW21Decoder.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace fw21 {
+
+// Read-only memory mapping of an entire file. The mapping is released
+// when the object is destroyed.
+class MappedFile {
+    void* m_data = nullptr;
+    std::size_t m_size = 0;
+
+   public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool is_open() const { return m_data != nullptr; }
+    std::size_t size() const { return m_size; }
+    std::string_view view() const {
+        return std::string_view(static_cast<const char*>(m_data), m_size);
+    }
+};
+
+// Decode a buffer holding either an FW21 file or a mesonet CSV export,
+// telling them apart by their header
+FW21Timeseries decode_station_data(
+    std::string_view data_buffer, unsigned n_threads = 0,
+    Precision met_precision = Precision::Float64);
+
+// Map the file at path and decode it straight from the mapping. Returns
+// nullptr if the file can't be opened or is empty. Callers opt in to
+// use_cache: a fresh binary cache next to the file (see FW21Cache.h)
+// is then loaded instead of decoding, and a new cache is written after
+// decoding, so the source directory must be writable.
+// n_threads and met_precision are passed on to decode_station_data, so
+// mesonet CSV files load as well.
+std::unique_ptr<FW21Timeseries> load_fw21_file(
+    const std::string& path, bool use_cache = false, unsigned n_threads = 0,
+    Precision met_precision = Precision::Float64);
+
+}  // namespace fw21
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef MESONET_DECODER_H
+#define MESONET_DECODER_H
+
+#include <NFDRSGUI/FW21Decoder.h>
+
+#include <string_view>
+
+namespace fw21 {
+
+// True if the header line of data_buffer has a mesonet STID column
+bool is_mesonet_csv(std::string_view data_buffer);
+
+// Decode a mesonet CSV export (STID, DateTime, RELH, TAIR, WSPD, WDIR,
+// WMAX, RAIN, SRAD, ...) into a timeseries in FW21 units. Columns are
+// found by their header name, so their order and any extra columns
+// don't matter; absent ones are left missing. Temperatures are
+// converted from C to F, speeds from m/s to mph, and the rain
+// accumulation since 00Z from mm to hourly inches. Returns an empty
+// series if the buffer has no DateTime column.
+FW21Timeseries decode_mesonet_csv(
+    std::string_view data_buffer,
+    Precision met_precision = Precision::Float64);
+
+}  // namespace fw21
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef MODELINPUTS_H
+#define MODELINPUTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fw21 {
+
+struct FW21Timeseries;
+
+// The rows of a FW21Timeseries as the fuel models take them: calendar
+// fields in UTC, SI units and a flag for rows with missing inputs. Built
+// once per timeseries (see FW21Timeseries::model_inputs) and read by
+// every model runner in place.
+struct ModelInputs {
+    // Number of rows converted so far
+    std::ptrdiff_t NT = 0;
+
+    std::vector<std::int16_t> year;
+    std::vector<std::uint8_t> month;
+    std::vector<std::uint8_t> day;
+    std::vector<std::uint8_t> hour;
+    std::vector<std::uint8_t> minute;
+    std::vector<std::uint8_t> second;
+    // deg C
+    std::vector<double> air_temperature;
+    // fraction
+    std::vector<double> relative_humidity;
+    // W m^-2
+    std::vector<double> solar_radiation;
+    // cm
+    std::vector<double> precipitation;
+    // Nonzero when none of the above are missing
+    std::vector<std::uint8_t> valid;
+    // Running hash of every field of every row, identifying the data
+    // the models see regardless of where it was loaded from
+    std::uint64_t hash = 0xcbf29ce484222325;
+
+    // Convert the rows of data past NT
+    void extend(const FW21Timeseries& data);
+};
+
+}  // namespace fw21
+
+#endif
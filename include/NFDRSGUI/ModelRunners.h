@@ -2,19 +2,37 @@
 #define MODEL_RUNNER_H
 
 #include <NFDRSGUI/FW21Decoder.h>
+#include <NFDRSGUI/Pipeline.h>
+#include <NFDRSGUI/Profiler.h>
+#include <NFDRSGUI/ResultCache.h>
+#include <NFDRSGUI/Scheduler.h>
 #include <deadfuelmoisture.h>
 #include <nfdrs4.h>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <future>
 #include <memory>
-#include <thread>
-
-#include "implot.h"
-#include "implot_internal.h"
+#include <string>
+#include <vector>
 
 namespace nfdrs {
+// The standard dead fuel size classes, by stick radius in cm
+struct DeadFuelClass {
+    double radius;
+    const char* name;
+};
+inline constexpr DeadFuelClass dead_fuel_classes[] = {{0.20, "1-hour"},
+                                                      {0.64, "10-hour"},
+                                                      {2.0, "100-hour"},
+                                                      {6.40, "1000-hour"}};
+
 struct DeadFuelSettings {
     double adsorption_rate;
     double desorption_rate = 0.06;
@@ -33,28 +51,196 @@ struct DeadFuelSettings {
     bool use_derived_stick_nodes = true;
 };
 
+// Push settings into model and initialize its stick, ready to be
+// stepped from the first row
+inline void apply_dead_fuel_settings(DeadFuelMoisture& model,
+                                     const DeadFuelSettings& settings) {
+    model.setRandomSeed(settings.random_seed);
+    model.setDiffusivitySteps(settings.diffusivity_steps);
+    model.setMoistureSteps(settings.moisture_steps);
+    model.setStickNodes(settings.stick_nodes);
+    model.setAdsorptionRate(settings.adsorption_rate);
+    model.setDesorptionRate(settings.desorption_rate);
+    model.setPlanarHeatTransferRate(settings.planar_heat_transfer_rate);
+    model.setStickLength(settings.stick_length);
+    model.setStickDensity(settings.stick_density);
+    model.setMaximumLocalMoisture(settings.max_local_moisture);
+    model.initializeStick();
+}
+
+// Step model through row i of inputs. Returns false, leaving the model
+// untouched, if any of its inputs are missing.
+inline bool update_dead_fuel(DeadFuelMoisture& model,
+                             const fw21::ModelInputs& inputs,
+                             std::ptrdiff_t i) {
+    if (!inputs.valid[i]) return false;
+    model.update(inputs.year[i], inputs.month[i], inputs.day[i],
+                 inputs.hour[i], inputs.minute[i], inputs.second[i],
+                 inputs.air_temperature[i], inputs.relative_humidity[i],
+                 inputs.solar_radiation[i], inputs.precipitation[i], 0.0218,
+                 true);
+    return true;
+}
+
+// Cache key of a dead fuel run of a stick of radius with settings over
+// inputs
+inline std::uint64_t dead_fuel_result_key(const fw21::ModelInputs& inputs,
+                                          double radius,
+                                          const DeadFuelSettings& settings) {
+    auto bits = [](double value) {
+        std::uint64_t word;
+        std::memcpy(&word, &value, sizeof(word));
+        return word;
+    };
+    std::uint64_t key = hash_combine(inputs.hash, inputs.NT);
+    key = hash_combine(key, bits(radius));
+    key = hash_combine(key, bits(settings.adsorption_rate));
+    key = hash_combine(key, bits(settings.desorption_rate));
+    key = hash_combine(key, bits(settings.planar_heat_transfer_rate));
+    key = hash_combine(key, bits(settings.max_local_moisture));
+    key = hash_combine(key, bits(settings.stick_density));
+    key = hash_combine(key, bits(settings.stick_length));
+    key = hash_combine(key, settings.diffusivity_steps);
+    key = hash_combine(key, settings.moisture_steps);
+    key = hash_combine(key, settings.stick_nodes);
+    key = hash_combine(key, settings.random_seed);
+    return key;
+}
+
+// Values of the settings to sweep over. Parameters without values keep
+// those of the base settings.
+struct DeadFuelSweep {
+    std::vector<int> random_seeds;
+    std::vector<int> stick_nodes;
+    std::vector<int> moisture_steps;
+    std::vector<int> diffusivity_steps;
+    std::vector<double> adsorption_rates;
+    std::vector<double> desorption_rates;
+
+    // Every combination of the listed values
+    std::vector<DeadFuelSettings> grid(const DeadFuelSettings& base) const;
+    // n_members combinations drawn at random from the listed values
+    std::vector<DeadFuelSettings> sample(const DeadFuelSettings& base,
+                                         std::size_t n_members,
+                                         unsigned seed) const;
+};
+
+// Per row distribution of an ensemble's output over its members
+struct DeadFuelEnvelope {
+    std::vector<double> min;
+    std::vector<double> p10;
+    std::vector<double> median;
+    std::vector<double> p90;
+    std::vector<double> max;
+
+    void resize(std::size_t n_rows);
+};
+
+// Runs many settings of one size class over the same data. Members step
+// through the data in lockstep blocks, spread over the Scheduler, and
+// each block is reduced into the envelope before the next one starts,
+// so memory use doesn't grow with the number of members.
+struct DeadFuelEnsemble {
+    // Rows per lockstep block
+    static constexpr std::ptrdiff_t block_rows = 256;
+
+    // Members to sample, and their spread (%) around the runner's rates,
+    // for the next run started from the settings window
+    int n_members = 32;
+    float rate_spread = 25.0f;
+
+    std::vector<DeadFuelSettings> members;
+    // Radial moisture (%) of the members
+    DeadFuelEnvelope moisture;
+    // Rows of the envelope computed so far. Rows below this count are
+    // final and safe to read while the ensemble is running.
+    std::atomic<std::ptrdiff_t> n_done = 0;
+    std::atomic<bool> cancel_requested = false;
+    std::future<void> process_task;
+
+    ~DeadFuelEnsemble() { cancel(); }
+
+    std::ptrdiff_t valid_rows() const {
+        return n_done.load(std::memory_order_acquire);
+    }
+    // Fraction of the rows computed so far
+    float progress() const {
+        return moisture.min.empty()
+                   ? 0.0f
+                   : static_cast<float>(valid_rows()) / moisture.min.size();
+    }
+
+    // Replace the members and run them for a stick of the given radius
+    // over data on the Scheduler. data must outlive the run.
+    void run(std::vector<DeadFuelSettings> new_members, double radius,
+             const std::string& name, const fw21::FW21Timeseries& data);
+    void calc(double radius, const std::string& name,
+              const fw21::FW21Timeseries& data);
+
+    bool running() const {
+        return process_task.valid() &&
+               (process_task.wait_for(std::chrono::seconds(0)) !=
+                std::future_status::ready);
+    }
+
+    // Stop the pending run, if any, within one block and wait for it
+    void cancel() {
+        cancel_requested = true;
+        if (process_task.valid()) process_task.get();
+        cancel_requested = false;
+    }
+};
+
+// Model state after stepping through rows [0, row), taken at the first
+// row of a day so a run can be resumed there
+struct DeadFuelSnapshot {
+    std::ptrdiff_t row;
+    DeadFuelMoisture state;
+};
+
 struct DeadFuelModelRunner {
     double radius;
     std::string name;
-    std::thread process_thread;
+    // The pending calc_dfm run on the shared Scheduler, or the fire
+    // danger pipeline reading or driving this runner, if any
+    std::shared_future<void> process_task;
     DeadFuelSettings settings;
     std::unique_ptr<DeadFuelMoisture> model;
-    std::unique_ptr<double[]> radial_moisture;
-    std::unique_ptr<double[]> fuel_temperature;
-    std::atomic<int> progress = 0;
-    const std::ptrdiff_t size;
-    bool finished = false;
+    std::vector<double> radial_moisture;
+    std::vector<double> fuel_temperature;
+    std::ptrdiff_t size;
+    // Number of rows the model has been stepped through. The worker
+    // publishes it with release ordering after writing each row, so the
+    // outputs below valid_rows() can be read while a run is going.
+    std::atomic<std::ptrdiff_t> n_done = 0;
+    // Checked by step_rows before every step; set by cancel()
+    std::atomic<bool> cancel_requested = false;
+    // Steps between the model steps recorded by the Tracer
+    static constexpr std::ptrdiff_t trace_step_interval = 1024;
+    // Parameter sweep around settings
+    DeadFuelEnsemble ensemble;
+    // The settings the model was last initialized with
+    DeadFuelSettings applied_settings;
+    // False when the outputs came from a cached result without the
+    // model state to continue from
+    bool model_synced = true;
+    // Days whose starting state is kept in snapshots; 0 disables them
+    std::size_t snapshot_days = 7;
+    // The model at the start of each of the last snapshot_days days
+    // stepped, in row order. Only valid for applied_settings and the rows
+    // they were taken over; rerun_from resumes from them.
+    std::deque<DeadFuelSnapshot> snapshots;
 
     DeadFuelModelRunner();
 
     DeadFuelModelRunner(double in_radius, const char* in_name,
                         const fw21::FW21Timeseries& data)
-        : size(data.NT), process_thread() {
+        : size(data.NT) {
         radius = in_radius;
         name = in_name;
         model = std::make_unique<DeadFuelMoisture>(radius, name);
-        radial_moisture = std::make_unique<double[]>(size);
-        fuel_temperature = std::make_unique<double[]>(size);
+        radial_moisture.resize(size);
+        fuel_temperature.resize(size);
 
         // get derived settings
         settings.adsorption_rate = model->adsorptionRate();
@@ -64,53 +250,200 @@ struct DeadFuelModelRunner {
         settings.moisture_steps = model->moistureSteps();
     }
 
-    ~DeadFuelModelRunner() {
-        if (process_thread.joinable()) process_thread.join();
-    }
-
-    void calc_dfm(const fw21::FW21Timeseries& data) {
-        for (int i = 0; i < data.NT; ++i) {
-            double at = (data.air_temperature[i] - 32.0) *
-                        (5. / 9.);  // convert to deg C
-            double rh = data.relative_humidity[i] / 100.0;
-            double sW = data.solar_radiation[i];
-            double rain = data.precipitation[i] * 2.54;  // convert to cm
+    ~DeadFuelModelRunner() { cancel(); }
 
-            if ((std::isnan(at)) || (std::isnan(rh)) || (std::isnan(sW)) ||
-                (std::isnan(rain))) {
+    // Step the model through rows [start, end), publishing each one.
+    // Returns the row it stopped at, which is before end if cancelled.
+    std::ptrdiff_t step_rows(const fw21::ModelInputs& inputs,
+                             std::ptrdiff_t start, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = start; i < end; ++i) {
+            NFDRS_TRACE_SAMPLE("model", "dfm step", name.c_str(),
+                               i % trace_step_interval == 0);
+            if (cancel_requested.load(std::memory_order_relaxed)) return i;
+            if ((i > 0) && (inputs.day[i] != inputs.day[i - 1])) {
+                take_snapshot(i);
+            }
+            if (!update_dead_fuel(*model, inputs, i)) {
                 radial_moisture[i] = std::nan("");
                 fuel_temperature[i] = std::nan("");
+                n_done.store(i + 1, std::memory_order_release);
                 continue;
             }
-            tm time_data;
-            ImPlotTime curtime = ImPlotTime::FromDouble(data.date_time[i]);
-            ImPlot::GetGmtTime(curtime, &time_data);
-
-            bool ret = model->update(
-                time_data.tm_year + 1900, time_data.tm_mon + 1,
-                time_data.tm_mday, time_data.tm_hour, time_data.tm_min,
-                time_data.tm_sec, at, rh, sW, rain, 0.0218, true);
             radial_moisture[i] = model->medianRadialMoisture() * 100.0;
             fuel_temperature[i] = model->meanWtdTemperature();
-            progress.store(100 * i / data.NT);
+            n_done.store(i + 1, std::memory_order_release);
+        }
+        return end;
+    }
+
+    // Record the model as the state before row, dropping the oldest
+    // snapshot (and reusing its node arrays) past snapshot_days
+    void take_snapshot(std::ptrdiff_t row) {
+        if (snapshot_days == 0) return;
+        if ((!snapshots.empty()) && (snapshots.back().row >= row)) return;
+        if (snapshots.size() < snapshot_days) {
+            snapshots.push_back({row, *model});
+            return;
+        }
+        snapshots.push_back(std::move(snapshots.front()));
+        snapshots.pop_front();
+        snapshots.back().row = row;
+        snapshots.back().state = *model;
+    }
+
+    void calc_dfm(const fw21::FW21Timeseries& data, std::ptrdiff_t start) {
+        NFDRS_PROFILE_TIMER(timer, "calc_dfm " + name, data.NT - start,
+                            "steps");
+        NFDRS_TRACE_SCOPE_DETAIL("model", "calc_dfm", name.c_str());
+        [[maybe_unused]] const std::ptrdiff_t stop =
+            step_rows(data.model_inputs(), start, data.NT);
+        NFDRS_PROFILE_WORK(timer, stop - start);
+    }
+
+    // Rows of the outputs that are safe to read
+    std::ptrdiff_t valid_rows() const {
+        return n_done.load(std::memory_order_acquire);
+    }
+    bool finished() const { return valid_rows() >= size; }
+    // Fraction of the rows computed so far
+    float progress() const {
+        return (size > 0) ? static_cast<float>(valid_rows()) / size : 0.0f;
+    }
+
+    // Push settings into the model and initialize its stick, ready for
+    // calc_dfm to start from the first row
+    void apply_settings() {
+        apply_dead_fuel_settings(*model, settings);
+        applied_settings = settings;
+        model_synced = true;
+        n_done = 0;
+        snapshots.clear();
+    }
+
+    std::uint64_t result_key(const fw21::FW21Timeseries& data) const {
+        return dead_fuel_result_key(data.model_inputs(), radius,
+                                    applied_settings);
+    }
+
+    // Fill the outputs from the ResultCache. Returns false on a miss.
+    bool restore_result(std::uint64_t key) {
+        std::shared_ptr<const DeadFuelResult> result =
+            ResultCache::instance().find(key);
+        if ((!result) || (result->radial_moisture.size() !=
+                          static_cast<std::size_t>(size))) {
+            return false;
         }
-        finished = true;
+        radial_moisture = result->radial_moisture;
+        fuel_temperature = result->fuel_temperature;
+        model_synced = (result->final_state != nullptr);
+        if (model_synced) *model = *result->final_state;
+        snapshots.clear();
+        n_done.store(size, std::memory_order_release);
+        return true;
     }
 
+    // Add the outputs of a run that reached the last row to the
+    // ResultCache
+    void store_result(std::uint64_t key) const {
+        if (n_done < size) return;
+        auto result = std::make_shared<DeadFuelResult>();
+        result->radial_moisture = radial_moisture;
+        result->fuel_temperature = fuel_temperature;
+        result->final_state = std::make_shared<const DeadFuelMoisture>(*model);
+        result->stick_nodes = applied_settings.stick_nodes;
+        ResultCache::instance().insert(key, std::move(result));
+    }
+
+    // Run from the first row, or just copy the outputs when the same
+    // settings have already been run over the same data
     void run(const fw21::FW21Timeseries& data) {
-        model->setRandomSeed(settings.random_seed);
-        model->setDiffusivitySteps(settings.diffusivity_steps);
-        model->setMoistureSteps(settings.moisture_steps);
-        model->setStickNodes(settings.stick_nodes);
-        model->setAdsorptionRate(settings.adsorption_rate);
-        model->setDesorptionRate(settings.desorption_rate);
-        model->setPlanarHeatTransferRate(settings.planar_heat_transfer_rate);
-        model->setStickLength(settings.stick_length);
-        model->setStickDensity(settings.stick_density);
-        model->setMaximumLocalMoisture(settings.max_local_moisture);
-        model->initializeStick();
-        process_thread =
-            std::thread(&DeadFuelModelRunner::calc_dfm, this, std::ref(data));
+        apply_settings();
+        process_task = Scheduler::instance().submit([this, &data]() {
+            const std::uint64_t key = result_key(data);
+            if (restore_result(key)) return;
+            calc_dfm(data, 0);
+            store_result(key);
+        });
+    }
+
+    bool running() const {
+        return process_task.valid() &&
+               (process_task.wait_for(std::chrono::seconds(0)) !=
+                std::future_status::ready);
+    }
+
+    // Block until the pending run, if any, has finished
+    void wait() {
+        if (process_task.valid()) process_task.get();
+    }
+
+    // Stop the pending run, if any, within one timestep and wait for it
+    void cancel() {
+        cancel_requested = true;
+        wait();
+        cancel_requested = false;
+    }
+
+    // Abandon the current run and start over from the first row with
+    // the current settings, reusing the output buffers
+    void restart(const fw21::FW21Timeseries& data) {
+        cancel();
+        if (model->updates() > 0) reset();
+        run(data);
+    }
+
+    // Recompute the rows from row onward, e.g. after they changed,
+    // resuming from the latest snapshot at or before row. Without one the
+    // run starts over. Returns the row the run resumes from.
+    std::ptrdiff_t rerun_from(const fw21::FW21Timeseries& data,
+                              std::ptrdiff_t row) {
+        cancel();
+        while ((!snapshots.empty()) && (snapshots.back().row > row)) {
+            snapshots.pop_back();
+        }
+        if ((snapshots.empty()) || (!model_synced)) {
+            restart(data);
+            return 0;
+        }
+
+        *model = snapshots.back().state;
+        const std::ptrdiff_t start = snapshots.back().row;
+        n_done = start;
+        process_task = Scheduler::instance().submit([this, &data, start]() {
+            calc_dfm(data, start);
+            store_result(result_key(data));
+        });
+        return start;
+    }
+
+    // Grow the output buffers to match data after rows were appended to
+    // it. If the model has already been run, continue from its current
+    // state over just the new rows. When append_fw21 replaced the last
+    // row the model had already stepped over, resume from the snapshot
+    // taken at the start of that row's day instead.
+    void extend(const fw21::FW21Timeseries& data,
+                bool last_row_replaced = false) {
+        wait();
+        const std::ptrdiff_t replaced_row = size - 1;
+        size = data.NT;
+        radial_moisture.resize(size);
+        fuel_temperature.resize(size);
+        if (n_done == 0) return;
+        if (last_row_replaced) {
+            rerun_from(data, replaced_row);
+            return;
+        }
+        if (n_done >= size) return;
+        if (!model_synced) {
+            restart(data);
+            return;
+        }
+
+        const std::ptrdiff_t start = n_done;
+        process_task = Scheduler::instance().submit([this, &data, start]() {
+            calc_dfm(data, start);
+            store_result(result_key(data));
+        });
     }
 
     void default_settings() {
@@ -124,14 +457,379 @@ struct DeadFuelModelRunner {
     }
 
     void reset() {
-        if (process_thread.joinable()) process_thread.join();
-        process_thread = std::thread();
-        progress = 0;
-        finished = false;
+        cancel();
+        n_done = 0;
+        snapshots.clear();
+        model_synced = true;
         model->initializeParameters(radius, name);
     }
 };
 
+enum class LiveFuelType { Herbaceous, Woody };
+
+// The defaults are those of NFDRS 2016 for herbaceous fuels; woody
+// fuels range from 60% to 200% instead (see default_settings)
+struct LiveFuelSettings {
+    // Station latitude in degrees north, for the photoperiod
+    double latitude = 40.0;
+    // Days in the running average of the daily GSI
+    int averaging_days = 21;
+    // Averaged GSI at which greenup starts
+    double greenup_threshold = 0.5;
+    // Moisture content (%) when dormant and at full greenness
+    double min_moisture = 30.0;
+    double max_moisture = 250.0;
+};
+
+// Running average of the daily Growing Season Index (Jolly et al.,
+// 2005), the product of the minimum temperature, vapor pressure deficit
+// and photoperiod indices. Hours are fed in one at a time and a day's
+// index is added to the average once the first hour of the next day
+// arrives, so the state can be carried over to rows appended later.
+class GrowingSeasonIndex {
+    double m_latitude;
+    // Completed daily indices, oldest overwritten first
+    std::vector<double> m_days;
+    std::size_t m_next = 0;
+    std::size_t m_n_days = 0;
+    double m_average = std::nan("");
+    // The day being accumulated
+    int m_year = -1;
+    int m_month = -1;
+    int m_day = -1;
+    double m_min_temperature = 0.0;
+    double m_vpd_sum = 0.0;
+    int m_n_hours = 0;
+
+    void close_day();
+
+   public:
+    explicit GrowingSeasonIndex(double latitude = 40.0,
+                                int averaging_days = 21);
+
+    // Add row i of inputs. Returns false, leaving the index untouched,
+    // if any of its inputs are missing.
+    bool update(const fw21::ModelInputs& inputs, std::ptrdiff_t i);
+    // Mean daily index over the completed days of the averaging
+    // window; NaN before the first day is complete
+    double average() const { return m_average; }
+};
+
+// Live fuel moisture content (%) of a fuel with settings at the averaged
+// Growing Season Index gsi: the minimum up to the greenup threshold,
+// rising linearly to the maximum at a GSI of 1, as in NFDRS 2016
+inline double live_fuel_moisture(const LiveFuelSettings& settings,
+                                 double gsi) {
+    if (std::isnan(gsi)) return gsi;
+    if (gsi < settings.greenup_threshold) return settings.min_moisture;
+    const double greenness = (gsi - settings.greenup_threshold) /
+                             (1.0 - settings.greenup_threshold);
+    return settings.min_moisture +
+           greenness * (settings.max_moisture - settings.min_moisture);
+}
+
+struct LiveFuelModelRunner {
+    LiveFuelType type;
+    std::string name;
+    // The pending calc_lfm run on the shared Scheduler, or the fire
+    // danger pipeline reading or driving this runner, if any
+    std::shared_future<void> process_task;
+    LiveFuelSettings settings;
+    GrowingSeasonIndex gsi;
+    std::vector<double> moisture;
+    std::vector<double> growing_season_index;
+    std::ptrdiff_t size;
+    // Number of rows the model has been stepped through, published with
+    // release ordering after each row is written
+    std::atomic<std::ptrdiff_t> n_done = 0;
+    // Checked by step_rows before every step; set by cancel()
+    std::atomic<bool> cancel_requested = false;
+    // The settings gsi was last initialized with
+    LiveFuelSettings applied_settings;
+
+    LiveFuelModelRunner(LiveFuelType in_type, const char* in_name,
+                        const fw21::FW21Timeseries& data)
+        : type(in_type), name(in_name), size(data.NT) {
+        default_settings();
+        moisture.resize(size);
+        growing_season_index.resize(size);
+    }
+
+    ~LiveFuelModelRunner() { cancel(); }
+
+    // Feed rows [start, end) to the index, publishing each one. Returns
+    // the row it stopped at, which is before end if cancelled.
+    std::ptrdiff_t step_rows(const fw21::ModelInputs& inputs,
+                             std::ptrdiff_t start, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = start; i < end; ++i) {
+            if (cancel_requested.load(std::memory_order_relaxed)) return i;
+            if (gsi.update(inputs, i)) {
+                growing_season_index[i] = gsi.average();
+                moisture[i] = live_fuel_moisture(applied_settings,
+                                                  growing_season_index[i]);
+            } else {
+                moisture[i] = std::nan("");
+                growing_season_index[i] = std::nan("");
+            }
+            n_done.store(i + 1, std::memory_order_release);
+        }
+        return end;
+    }
+
+    void calc_lfm(const fw21::FW21Timeseries& data, std::ptrdiff_t start) {
+        NFDRS_TRACE_SCOPE_DETAIL("model", "calc_lfm", name.c_str());
+        step_rows(data.model_inputs(), start, data.NT);
+    }
+
+    // Rows of the outputs that are safe to read
+    std::ptrdiff_t valid_rows() const {
+        return n_done.load(std::memory_order_acquire);
+    }
+    bool finished() const { return valid_rows() >= size; }
+    // Fraction of the rows computed so far
+    float progress() const {
+        return (size > 0) ? static_cast<float>(valid_rows()) / size : 0.0f;
+    }
+
+    // Start the Growing Season Index over with the current settings,
+    // ready for calc_lfm to start from the first row
+    void apply_settings() {
+        gsi = GrowingSeasonIndex(settings.latitude, settings.averaging_days);
+        applied_settings = settings;
+        n_done = 0;
+    }
+
+    void run(const fw21::FW21Timeseries& data) {
+        apply_settings();
+        process_task = Scheduler::instance().submit(
+            [this, &data]() { calc_lfm(data, 0); });
+    }
+
+    bool running() const {
+        return process_task.valid() &&
+               (process_task.wait_for(std::chrono::seconds(0)) !=
+                std::future_status::ready);
+    }
+
+    // Block until the pending run, if any, has finished
+    void wait() {
+        if (process_task.valid()) process_task.get();
+    }
+
+    // Stop the pending run, if any, within one timestep and wait for it
+    void cancel() {
+        cancel_requested = true;
+        wait();
+        cancel_requested = false;
+    }
+
+    // Abandon the current run and start over from the first row with
+    // the current settings
+    void restart(const fw21::FW21Timeseries& data) {
+        reset();
+        run(data);
+    }
+
+    // Grow the output buffers to match data after rows were appended to
+    // it. If the model has already been run, continue accumulating the
+    // index over just the new rows, or start over when append_fw21
+    // replaced a row the index already includes.
+    void extend(const fw21::FW21Timeseries& data,
+                bool last_row_replaced = false) {
+        wait();
+        size = data.NT;
+        moisture.resize(size);
+        growing_season_index.resize(size);
+        if (n_done == 0) return;
+        if (last_row_replaced) {
+            restart(data);
+            return;
+        }
+        if (n_done >= size) return;
+
+        const std::ptrdiff_t start = n_done;
+        process_task = Scheduler::instance().submit(
+            [this, &data, start]() { calc_lfm(data, start); });
+    }
+
+    void default_settings() {
+        const double latitude = settings.latitude;
+        settings = LiveFuelSettings();
+        settings.latitude = latitude;
+        if (type == LiveFuelType::Woody) {
+            settings.min_moisture = 60.0;
+            settings.max_moisture = 200.0;
+        }
+    }
+
+    void reset() {
+        cancel();
+        n_done = 0;
+    }
+};
+
+// NFDRS 2016 fuel model, as selected in NFDRS4 by its code
+struct NFDRSFuelModel {
+    char code;
+    const char* description;
+};
+
+inline constexpr NFDRSFuelModel nfdrs_fuel_models[] = {{'V', "Grass"},
+                                                       {'W', "Grass-Shrub"},
+                                                       {'X', "Brush"},
+                                                       {'Y', "Timber"},
+                                                       {'Z', "Slash"}};
+
+// One hour of inputs to the fire danger indices. Moisture contents are
+// in %, the 1-hour fuel temperature in deg C and the 20 ft wind speed in
+// mph.
+struct FireDangerInputs {
+    double mc1, mc10, mc100, mc1000, mc_herb, mc_wood;
+    double fuel_temperature;
+    double wind_speed;
+};
+
+struct FireDangerIndices {
+    double energy_release;
+    double burning_index;
+    double ignition_component;
+    double spread_component;
+};
+
+struct NFDRSSettings {
+    // Index into nfdrs_fuel_models
+    int fuel_model = 1;
+    int slope_class = 1;
+    // Hour of the daily observation
+    int obs_hour = 13;
+};
+
+// Initialize model for the fuel model, slope class and observation hour
+// of settings at a station at latitude (degrees north)
+void init_fire_danger(NFDRS4& model, const NFDRSSettings& settings,
+                      double latitude);
+
+// The NFDRS4 indices for one hour of inputs on slope_class 1-5, from
+// model after init_fire_danger. NaN if any input is missing.
+FireDangerIndices calc_fire_danger(NFDRS4& model, int slope_class,
+                                   const FireDangerInputs& inputs);
+
+// Fire danger indices from the outputs of the dead and live fuel moisture
+// runners. run() builds a Pipeline whose index stage reads each hour of
+// the runners' outputs once all of them have published it.
+struct NFDRSModelRunner {
+    // Rows a pipeline stage handles per turn
+    static constexpr std::ptrdiff_t pipeline_chunk_rows = 64;
+    // Rows a fuel moisture stage may publish ahead of the indices before
+    // it blocks, leaving the workers to the stages behind it
+    static constexpr std::ptrdiff_t pipeline_window_rows =
+        16 * pipeline_chunk_rows;
+
+    // The pending pipeline, if any. The fuel moisture runners it depends
+    // on hold the same future until it is done.
+    std::shared_future<void> process_task;
+    std::shared_ptr<Pipeline> pipeline;
+    NFDRSSettings settings;
+    // Hourly indices
+    std::vector<double> energy_release;
+    std::vector<double> burning_index;
+    std::vector<double> ignition_component;
+    std::vector<double> spread_component;
+    // The indices at obs_hour of each day, and the times of those rows
+    std::vector<double> daily_time;
+    std::vector<double> daily_energy_release;
+    std::vector<double> daily_burning_index;
+    std::vector<double> daily_ignition_component;
+    std::vector<double> daily_spread_component;
+    std::ptrdiff_t size;
+    // Number of rows the hourly indices have been computed for,
+    // published with release ordering. The daily indices are only safe to
+    // read once finished().
+    std::atomic<std::ptrdiff_t> n_done = 0;
+    // Inputs of each row, gathered from the fuel moisture runners
+    std::vector<FireDangerInputs> inputs;
+    NFDRSSettings applied_settings;
+    // Computes the indices; used by one run at a time
+    std::unique_ptr<NFDRS4> model = std::make_unique<NFDRS4>();
+
+    explicit NFDRSModelRunner(const fw21::FW21Timeseries& data)
+        : size(data.NT) {}
+
+    ~NFDRSModelRunner() { cancel(); }
+
+    // Compute the indices of row i from inputs[i]
+    void calc_row(const fw21::FW21Timeseries& data,
+                  const fw21::ModelInputs& model_inputs, std::ptrdiff_t i) {
+        const FireDangerIndices indices =
+            calc_fire_danger(*model, applied_settings.slope_class, inputs[i]);
+        energy_release[i] = indices.energy_release;
+        burning_index[i] = indices.burning_index;
+        ignition_component[i] = indices.ignition_component;
+        spread_component[i] = indices.spread_component;
+        if ((model_inputs.hour[i] == applied_settings.obs_hour) &&
+            (!std::isnan(indices.energy_release))) {
+            daily_time.push_back(data.date_time[i]);
+            daily_energy_release.push_back(indices.energy_release);
+            daily_burning_index.push_back(indices.burning_index);
+            daily_ignition_component.push_back(indices.ignition_component);
+            daily_spread_component.push_back(indices.spread_component);
+        }
+    }
+
+    // Rows of the hourly indices that are safe to read
+    std::ptrdiff_t valid_rows() const {
+        return n_done.load(std::memory_order_acquire);
+    }
+    bool finished() const { return valid_rows() >= size; }
+    // Fraction of the rows computed so far
+    float progress() const {
+        return (size > 0) ? static_cast<float>(valid_rows()) / size : 0.0f;
+    }
+
+    // Compute the indices of data from the given fuel moisture runners.
+    // Runners that have finished are read as they are. The others are
+    // started over with their current settings by stages of the
+    // pipeline, which fill their outputs (or restore them from the
+    // ResultCache) while the indices follow behind. Until the pipeline
+    // is done every runner reports running(), and cancelling any of them
+    // cancels it.
+    void run(const fw21::FW21Timeseries& data, DeadFuelModelRunner& dfm_1h,
+             DeadFuelModelRunner& dfm_10h, DeadFuelModelRunner& dfm_100h,
+             DeadFuelModelRunner& dfm_1000h, LiveFuelModelRunner& lfm_herb,
+             LiveFuelModelRunner& lfm_woody);
+
+    bool running() const {
+        return process_task.valid() &&
+               (process_task.wait_for(std::chrono::seconds(0)) !=
+                std::future_status::ready);
+    }
+
+    // Block until the pending run, if any, has finished
+    void wait() {
+        if (process_task.valid()) process_task.get();
+        pipeline.reset();
+    }
+
+    // Stop the pending pipeline, if any, within one turn of each stage
+    // and wait for it
+    void cancel() {
+        if (pipeline) pipeline->cancel();
+        wait();
+    }
+
+    void default_settings() { settings = NFDRSSettings(); }
+
+    void reset() {
+        cancel();
+        n_done = 0;
+        daily_time.clear();
+        daily_energy_release.clear();
+        daily_burning_index.clear();
+        daily_ignition_component.clear();
+        daily_spread_component.clear();
+    }
+};
+
 }  // namespace nfdrs
 
 #endif
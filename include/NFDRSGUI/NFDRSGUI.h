@@ -5,6 +5,7 @@
 #include <cmath>
 #include <cstddef>
 #include <memory>
+#include <string>
 #include <string_view>
 
 #ifdef __EMSCRIPTEN__
@@ -31,14 +32,28 @@ void dead_fuel_settings(bool& enabled, DeadFuelModelRunner& dfm_1h,
                         DeadFuelModelRunner& dfm_1000h,
                         fw21::FW21Timeseries& data);
 
-void live_fuel_settings(bool& enabled);
-void nfdrs_settings(bool& enabled);
+void live_fuel_settings(bool& enabled, LiveFuelModelRunner& lfm_herb,
+                        LiveFuelModelRunner& lfm_woody,
+                        fw21::FW21Timeseries& data);
+void nfdrs_settings(bool& enabled, NFDRSModelRunner& indices,
+                    DeadFuelModelRunner& dfm_1h,
+                    DeadFuelModelRunner& dfm_10h,
+                    DeadFuelModelRunner& dfm_100h,
+                    DeadFuelModelRunner& dfm_1000h,
+                    LiveFuelModelRunner& lfm_herb,
+                    LiveFuelModelRunner& lfm_woody,
+                    fw21::FW21Timeseries& data);
+// Timings recorded by the NFDRS_PROFILE_* macros
+void performance_window(bool& enabled);
 
 void meteogram(const std::unique_ptr<fw21::FW21Timeseries>& met_data,
                const DeadFuelModelRunner& dfm_1h,
                const DeadFuelModelRunner& dfm_10h,
                const DeadFuelModelRunner& dfm_100h,
                const DeadFuelModelRunner& dfm_1000h,
+               const LiveFuelModelRunner& lfm_herb,
+               const LiveFuelModelRunner& lfm_woody,
+               const NFDRSModelRunner& indices,
                const ImVec2 resize_thresh);
 
 static void glfw_error_callback(int error, const char* description) {
@@ -84,7 +99,20 @@ class MainApp {
     bool show_dead_fuel_settings = false;
     bool show_live_fuel_settings = false;
     bool show_nfdrs_settings = false;
+    bool show_performance = false;
     bool show_upload_window = false;
+    bool show_open_window = false;
+
+    // File requested from the command line or the "Open File" window,
+    // loaded at the start of the next frame
+    std::string m_pending_file;
+    // File the current data came from, and whether to keep appending
+    // rows as it grows
+    std::string m_loaded_file;
+    bool m_follow_file = false;
+    // Write and reuse <file>.nfc decode caches next to opened files
+    bool m_use_decode_cache = false;
+    static constexpr double m_follow_interval = 5.0;
 
    public:
     MainApp() {
@@ -219,6 +247,10 @@ class MainApp {
         glfwTerminate();
     }
 
+    // Queue a FW21 file to be memory mapped and decoded at the start
+    // of the next frame (native builds only)
+    void open_file(const std::string& path) { m_pending_file = path; }
+
     void RenderLoop();
 };
 
@@ -0,0 +1,60 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace nfdrs {
+
+// A graph of stages run cooperatively on the shared Scheduler. Each call
+// to a stage does a bounded amount of work and reports whether it made
+// progress, is blocked on its neighbours (waiting for input, or for a
+// consumer to catch up), or is done. Progress reschedules the stage
+// behind whatever else is queued and wakes its neighbours; a blocked
+// stage sleeps until a neighbour wakes it, so no worker ever waits on
+// another. A stage that reads what another produces must be connected
+// to it.
+class Pipeline : public std::enable_shared_from_this<Pipeline> {
+   public:
+    enum class Status { Progress, Blocked, Done };
+    using Stage = std::function<Status()>;
+
+   private:
+    enum State : int { Idle, Queued, Running, Notified, Finished };
+
+    struct Node {
+        Stage stage;
+        std::atomic<int> state = Idle;
+        std::vector<std::size_t> neighbours;
+    };
+
+    std::vector<std::unique_ptr<Node>> m_nodes;
+    std::atomic<std::size_t> m_n_unfinished = 0;
+    std::atomic<bool> m_cancel_requested = false;
+    std::promise<void> m_finished;
+
+    void wake(std::size_t node);
+    void run(std::size_t node);
+
+   public:
+    // Returns the id of the new stage
+    std::size_t add_stage(Stage stage);
+    // from feeds to. Each is woken when the other makes progress or
+    // finishes.
+    void connect(std::size_t from, std::size_t to);
+
+    // Schedule every stage. The future is ready once all of them are
+    // done. The stages must not be changed afterwards.
+    std::future<void> start();
+    // Stop every stage at its next turn, as if it were done. May be
+    // called from a stage.
+    void cancel();
+};
+
+}  // namespace nfdrs
+
+#endif
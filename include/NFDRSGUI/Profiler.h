@@ -0,0 +1,243 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Set by the NFDRSGUI_PROFILING CMake option
+#ifndef NFDRSGUI_PROFILING
+#define NFDRSGUI_PROFILING 0
+#endif
+
+namespace nfdrs {
+
+// Rolling timings and sampled values, recorded through the
+// NFDRS_PROFILE_* macros below. Meant for coarse scopes (a decode, a
+// model run, a subplot per frame), not inner loops. Thread safe.
+class Profiler {
+   public:
+    // Samples kept per metric
+    static constexpr std::size_t history_size = 128;
+
+    struct Metric {
+        std::string name;
+        // Timers record seconds; gauges record sampled values
+        bool is_timer = true;
+        // Unit of work for timers that report a rate, e.g. "MB"
+        std::string work_unit;
+        // Ring of the last history_size samples, oldest at next once
+        // full. Timer samples are in ms.
+        std::vector<float> history;
+        std::size_t next = 0;
+        std::size_t count = 0;
+        double last = 0.0;
+        double total = 0.0;
+        // Work per second of the last sample
+        double last_rate = 0.0;
+
+        double mean() const { return (count > 0) ? total / count : 0.0; }
+    };
+
+    static Profiler& instance();
+
+    void record_time(std::string_view name, double seconds, double work = 0.0,
+                     std::string_view work_unit = std::string_view());
+    void record_value(std::string_view name, double value);
+
+    // Copies of every metric, in name order
+    std::vector<Metric> metrics() const;
+    void clear();
+
+    std::string to_json() const;
+    // Returns false, with a message on std::cerr, if path can't be
+    // written
+    bool write_json(const std::string& path) const;
+
+   private:
+    Metric& metric(std::string_view name, bool is_timer);
+    static void add_sample(Metric& metric, double value);
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, Metric, std::less<>> m_metrics;
+};
+
+// Records the time from construction to destruction under name, with
+// an optional amount of work done to report a rate
+class ScopedTimer {
+    using Clock = std::chrono::steady_clock;
+
+    std::string m_name;
+    double m_work;
+    const char* m_work_unit;
+    Clock::time_point m_start;
+
+   public:
+    explicit ScopedTimer(std::string name, double work = 0.0,
+                         const char* work_unit = "")
+        : m_name(std::move(name)),
+          m_work(work),
+          m_work_unit(work_unit),
+          m_start(Clock::now()) {}
+    ~ScopedTimer() {
+        const std::chrono::duration<double> elapsed = Clock::now() - m_start;
+        Profiler::instance().record_time(m_name, elapsed.count(), m_work,
+                                         m_work_unit);
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    void set_work(double work) { m_work = work; }
+};
+
+// Timelines of spans on every thread, exported as Chrome trace event
+// JSON for chrome://tracing or ui.perfetto.dev. Off until enabled.
+// Every thread records into its own ring of the latest events, so
+// recording never waits on another thread.
+class Tracer {
+   public:
+    struct Event {
+        // String literals, as only the pointers are kept
+        const char* category;
+        const char* name;
+        std::int64_t start_ns;
+        std::int64_t end_ns;
+        // Copied, and cut to fit
+        char detail[32];
+    };
+
+    static constexpr std::size_t default_capacity = 1 << 16;
+
+    static Tracer& instance();
+
+    bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+    void enable(bool on = true) {
+        m_enabled.store(on, std::memory_order_relaxed);
+    }
+    // Events kept per thread, for threads that haven't recorded yet
+    void set_capacity(std::size_t events_per_thread);
+    // Name the calling thread in the exported trace
+    void set_thread_name(std::string_view name);
+
+    // Nanoseconds since the tracer was created
+    std::int64_t now_ns() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - m_epoch)
+            .count();
+    }
+    void record(const char* category, const char* name, const char* detail,
+                std::int64_t start_ns, std::int64_t end_ns);
+    // Drop the recorded events of every thread
+    void clear();
+
+    std::string to_json() const;
+    // Returns false, with a message on std::cerr, if path can't be
+    // written
+    bool write_json(const std::string& path) const;
+
+   private:
+    struct ThreadBuffer {
+        std::mutex mutex;
+        std::vector<Event> events;
+        // Oldest event once the ring is full
+        std::size_t next = 0;
+        std::size_t capacity;
+        int tid;
+        std::string name;
+    };
+
+    Tracer() : m_epoch(std::chrono::steady_clock::now()) {}
+    ThreadBuffer& thread_buffer();
+
+    std::atomic<bool> m_enabled = false;
+    const std::chrono::steady_clock::time_point m_epoch;
+    mutable std::mutex m_mutex;
+    // Kept after their threads exit, so their events can be exported
+    std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+    std::size_t m_capacity = default_capacity;
+};
+
+// Records a span from construction to destruction while the Tracer is
+// enabled and sample is true
+class TraceScope {
+    const char* m_category;
+    const char* m_name;
+    const char* m_detail;
+    std::int64_t m_start_ns = 0;
+    bool m_active;
+
+   public:
+    TraceScope(const char* category, const char* name,
+               const char* detail = nullptr, bool sample = true)
+        : m_category(category),
+          m_name(name),
+          m_detail(detail),
+          m_active(sample && Tracer::instance().enabled()) {
+        if (m_active) m_start_ns = Tracer::instance().now_ns();
+    }
+    ~TraceScope() {
+        if (!m_active) return;
+        Tracer& tracer = Tracer::instance();
+        tracer.record(m_category, m_name, m_detail, m_start_ns,
+                      tracer.now_ns());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+}  // namespace nfdrs
+
+// The macros compile to nothing, without evaluating their arguments,
+// when profiling is off.
+#if NFDRSGUI_PROFILING
+#define NFDRS_PROFILE_CONCAT_(a, b) a##b
+#define NFDRS_PROFILE_CONCAT(a, b) NFDRS_PROFILE_CONCAT_(a, b)
+// Time the rest of the enclosing scope
+#define NFDRS_PROFILE_SCOPE(name)                                   \
+    ::nfdrs::ScopedTimer NFDRS_PROFILE_CONCAT(nfdrs_profile_timer_, \
+                                              __LINE__)(name)
+// Time the rest of the enclosing scope as timer, which did work units
+// of work_unit, adjustable later with NFDRS_PROFILE_WORK
+#define NFDRS_PROFILE_TIMER(timer, name, work, work_unit) \
+    ::nfdrs::ScopedTimer timer(name, work, work_unit)
+#define NFDRS_PROFILE_WORK(timer, work) timer.set_work(work)
+// Sample a value such as a queue depth
+#define NFDRS_PROFILE_VALUE(name, value) \
+    ::nfdrs::Profiler::instance().record_value(name, value)
+// Trace the rest of the enclosing scope. category and name must be
+// string literals; detail is copied.
+#define NFDRS_TRACE_SCOPE(category, name)                          \
+    ::nfdrs::TraceScope NFDRS_PROFILE_CONCAT(nfdrs_trace_scope_, \
+                                             __LINE__)(category, name)
+#define NFDRS_TRACE_SCOPE_DETAIL(category, name, detail)           \
+    ::nfdrs::TraceScope NFDRS_PROFILE_CONCAT(nfdrs_trace_scope_, \
+                                             __LINE__)(category, name, detail)
+// Only trace the scopes for which sample is true, e.g. every Nth step
+#define NFDRS_TRACE_SAMPLE(category, name, detail, sample)             \
+    ::nfdrs::TraceScope NFDRS_PROFILE_CONCAT(nfdrs_trace_scope_,     \
+                                             __LINE__)(category, name, \
+                                                       detail, sample)
+#define NFDRS_TRACE_THREAD_NAME(name) \
+    ::nfdrs::Tracer::instance().set_thread_name(name)
+#else
+#define NFDRS_PROFILE_SCOPE(name) ((void)0)
+#define NFDRS_PROFILE_TIMER(timer, name, work, work_unit) ((void)0)
+#define NFDRS_PROFILE_WORK(timer, work) ((void)0)
+#define NFDRS_PROFILE_VALUE(name, value) ((void)0)
+#define NFDRS_TRACE_SCOPE(category, name) ((void)0)
+#define NFDRS_TRACE_SCOPE_DETAIL(category, name, detail) ((void)0)
+#define NFDRS_TRACE_SAMPLE(category, name, detail, sample) ((void)0)
+#define NFDRS_TRACE_THREAD_NAME(name) ((void)0)
+#endif
+
+#endif
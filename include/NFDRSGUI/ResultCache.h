@@ -0,0 +1,98 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <deadfuelmoisture.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nfdrs {
+
+// Mix value into a running 64-bit hash
+inline std::uint64_t hash_combine(std::uint64_t seed, std::uint64_t value) {
+    seed ^= value + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2);
+    // splitmix64 finalizer
+    seed = (seed ^ (seed >> 30)) * 0xbf58476d1ce4e5b9;
+    seed = (seed ^ (seed >> 27)) * 0x94d049bb133111eb;
+    return seed ^ (seed >> 31);
+}
+
+// The outputs of a completed dead fuel run
+struct DeadFuelResult {
+    std::vector<double> radial_moisture;
+    std::vector<double> fuel_temperature;
+    // The model after the last row, so the run can be extended.
+    // nullptr for results read back from disk.
+    std::shared_ptr<const DeadFuelMoisture> final_state;
+    // Stick nodes of final_state, whose per-node arrays live on the heap
+    int stick_nodes = 0;
+
+    // Bytes held, including the per-node arrays of final_state
+    std::size_t memory_usage() const;
+};
+
+// Completed model runs, keyed by a hash of everything that determines
+// them (see dead_fuel_result_key). Recently used results are held in
+// memory up to a byte budget; the least recently used are dropped, or
+// written to the spill directory when one is set and read back from
+// there on demand. Thread safe.
+class ResultCache {
+    struct Entry {
+        std::uint64_t key;
+        std::shared_ptr<const DeadFuelResult> result;
+        // already in the spill directory, so eviction needn't write it
+        bool on_disk = false;
+    };
+
+    mutable std::mutex m_mutex;
+    // most recently used first
+    std::list<Entry> m_entries;
+    std::unordered_map<std::uint64_t, std::list<Entry>::iterator> m_index;
+    std::size_t m_budget;
+    std::size_t m_usage = 0;
+    std::string m_spill_directory;
+
+    // Drop entries past the budget, returning them
+    std::vector<Entry> evict();
+    std::string spill_path(std::uint64_t key) const;
+    bool spill(const Entry& entry) const;
+    std::shared_ptr<const DeadFuelResult> unspill(std::uint64_t key) const;
+
+   public:
+    static constexpr std::size_t default_budget = 256 << 20;
+
+    explicit ResultCache(std::size_t budget = default_budget,
+                         std::string spill_directory = std::string());
+
+    // The process-wide cache used by the model runners
+    static ResultCache& instance();
+
+    // Results evicted from memory are written to spill_directory, which
+    // is created if needed. An empty path turns spilling off. Spill
+    // files are named by key, so they are found again by later
+    // processes; with a budget of 0 every result is written through.
+    void set_spill_directory(std::string spill_directory);
+    void set_budget(std::size_t budget);
+    // Bytes held in memory
+    std::size_t memory_usage() const;
+
+    // nullptr when key was never stored, or was evicted without a spill
+    // directory
+    std::shared_ptr<const DeadFuelResult> find(std::uint64_t key);
+    // on_disk marks a result read back from the spill directory, which
+    // isn't written again when evicted
+    void insert(std::uint64_t key,
+                std::shared_ptr<const DeadFuelResult> result,
+                bool on_disk = false);
+    void clear();
+};
+
+}  // namespace nfdrs
+
+#endif
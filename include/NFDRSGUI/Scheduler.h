@@ -0,0 +1,107 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nfdrs {
+
+// A fixed size, work-stealing thread pool shared by the whole process.
+// Every worker owns a task queue; tasks submitted from a worker go to
+// its own queue and are run newest first, while idle workers steal the
+// oldest tasks from the others.
+//
+// Tasks must not block on the futures of other tasks, as every worker
+// might end up waiting. Use parallel_for, whose caller works through
+// the loop itself, or completion callbacks instead.
+class Scheduler {
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_wake;
+    std::atomic<std::size_t> m_pending = 0;
+    std::atomic<unsigned> m_next_queue = 0;
+    bool m_stopping = false;
+
+    void push(std::function<void()> task);
+    bool try_pop(std::size_t queue, std::function<void()>& task);
+    void worker_loop(std::size_t queue);
+
+   public:
+    // n_threads of 0 means one per core. The web build is capped at the
+    // preallocated pthread pool (PTHREAD_POOL_SIZE).
+    explicit Scheduler(unsigned n_threads = 0);
+    ~Scheduler();
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    // The process-wide pool, created on first use with n_threads
+    // workers. Later calls ignore n_threads.
+    static Scheduler& instance(unsigned n_threads = 0);
+
+    unsigned size() const { return static_cast<unsigned>(m_threads.size()); }
+
+    // Tasks queued but not yet started
+    std::size_t pending() const {
+        return m_pending.load(std::memory_order_relaxed);
+    }
+
+    // Queue task without a way to wait for it
+    void post(std::function<void()> task) { push(std::move(task)); }
+
+    // Queue task and return a future for its result
+    template <typename Task>
+    auto submit(Task&& task) -> std::future<std::invoke_result_t<Task>> {
+        using Result = std::invoke_result_t<Task>;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(
+            std::forward<Task>(task));
+        std::future<Result> result = packaged->get_future();
+        push([packaged]() { (*packaged)(); });
+        return result;
+    }
+
+    // Queue task and hand its result to on_complete, on the worker that
+    // ran it
+    template <typename Task, typename Callback>
+    void submit(Task&& task, Callback&& on_complete) {
+        push([task = std::forward<Task>(task),
+              on_complete = std::forward<Callback>(on_complete)]() mutable {
+            if constexpr (std::is_void_v<std::invoke_result_t<Task>>) {
+                task();
+                on_complete();
+            } else {
+                on_complete(task());
+            }
+        });
+    }
+
+    // Call body(idx) for every idx in [0, n) across the pool and the
+    // calling thread, returning once all calls have finished. At most
+    // max_threads threads (0 means no limit) work on the loop. The
+    // caller only ever runs iterations of this loop, and sleeps while
+    // the last ones finish elsewhere, so it is safe to use from inside a
+    // task.
+    void parallel_for(std::size_t n,
+                      const std::function<void(std::size_t)>& body,
+                      unsigned max_threads = 0);
+};
+
+}  // namespace nfdrs
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef STATION_STORE_H
+#define STATION_STORE_H
+
+#include <NFDRSGUI/FW21Decoder.h>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fw21 {
+
+// A contiguous, time-ordered range of rows of one station's series. The
+// slice points into the series' own columns; nothing is copied.
+struct TimeSlice {
+    const FW21Timeseries* series = nullptr;
+    std::ptrdiff_t begin = 0;
+    std::ptrdiff_t end = 0;
+
+    std::ptrdiff_t size() const { return end - begin; }
+    bool empty() const { return end <= begin; }
+
+    // Pointer to the first row of the slice in one of the series'
+    // plain columns, e.g. slice.column(&FW21Timeseries::date_time)
+    template <typename T>
+    const T* column(Column<T> FW21Timeseries::*member) const {
+        return (series->*member).data() + begin;
+    }
+    // Row idx of the slice in a meteorological column, e.g.
+    // slice.value(&FW21Timeseries::air_temperature, 0)
+    double value(MetColumn FW21Timeseries::*member,
+                 std::ptrdiff_t idx) const {
+        return (series->*member)[begin + idx];
+    }
+};
+
+// Holds the decoded series of many stations, keyed by station ID (or by
+// source path for files without one). Every
+// series is kept sorted by time with unique timestamps, which is the
+// index that time range queries binary search.
+class StationStore {
+    std::map<std::string, std::unique_ptr<FW21Timeseries>> m_stations;
+
+   public:
+    // Decode every *.fw21 file in directory on up to n_threads threads
+    // of the shared Scheduler (0 means the whole pool) and add them to
+    // the store, keeping the
+    // meteorological columns at met_precision. use_cache is passed on
+    // to load_fw21_file. Returns the number of files loaded.
+    std::size_t load_directory(const std::string& directory,
+                               unsigned n_threads = 0,
+                               Precision met_precision = Precision::Float64,
+                               bool use_cache = false);
+
+    // Add a series to the store. A series for a station that is already
+    // present (e.g. another year of the same station) is merged into
+    // the existing one. A series without a station ID is stored under
+    // source_path instead, and never merged. Rows whose timestamp failed
+    // to decode are dropped first, and reported on std::cerr. Returns
+    // false, without storing it, if the series has neither a station ID
+    // nor a source_path, or no valid rows.
+    bool insert(std::unique_ptr<FW21Timeseries> series,
+                const std::string& source_path = {});
+
+    // nullptr if the station is unknown
+    const FW21Timeseries* find(const std::string& station_id) const;
+
+    // Rows of station_id with t0 <= date_time <= t1
+    TimeSlice slice(const std::string& station_id, double t0,
+                    double t1) const;
+
+    std::vector<std::string> station_ids() const;
+    std::size_t size() const { return m_stations.size(); }
+    bool empty() const { return m_stations.empty(); }
+
+    auto begin() const { return m_stations.cbegin(); }
+    auto end() const { return m_stations.cend(); }
+};
+
+}  // namespace fw21
+
+#endif
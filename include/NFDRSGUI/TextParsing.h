@@ -0,0 +1,131 @@
+#ifndef TEXT_PARSING_H
+#define TEXT_PARSING_H
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+// Allocation free field and line scanning shared by the text decoders
+namespace fw21::text {
+
+// Exact powers of ten for the fast path of parse_double. Every
+// integer mantissa below 2^53 scaled by one of these is correctly
+// rounded by a single IEEE multiply or divide.
+inline constexpr double pow10_table[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Convert the characters in [first, last) to a double without
+// allocating. Plain decimal numbers (the only thing FW21 and mesonet
+// files contain) take the fast path; anything else is handed to strtod
+// from a stack buffer. Empty or malformed fields become NaN.
+inline double parse_double(const char* first, const char* last) {
+    if (first == last) return std::nan("");
+
+    const char* p = first;
+    bool negative = false;
+    if ((*p == '-') || (*p == '+')) {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    std::uint64_t mantissa = 0;
+    int n_digits = 0;
+    int exponent = 0;
+    bool any_digits = false;
+    for (; (p != last) && (*p >= '0') && (*p <= '9'); ++p) {
+        mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+        if (mantissa != 0) ++n_digits;
+        any_digits = true;
+    }
+    if ((p != last) && (*p == '.')) {
+        ++p;
+        for (; (p != last) && (*p >= '0') && (*p <= '9'); ++p) {
+            mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+            if (mantissa != 0) ++n_digits;
+            --exponent;
+            any_digits = true;
+        }
+    }
+
+    if ((p == last) && any_digits && (n_digits <= 15) && (exponent >= -22)) {
+        double value = static_cast<double>(mantissa) / pow10_table[-exponent];
+        return negative ? -value : value;
+    }
+
+    // Slow path: exponents, very long mantissas, or garbage
+    char buffer[64];
+    const std::ptrdiff_t len = last - first;
+    if (len >= static_cast<std::ptrdiff_t>(sizeof(buffer))) {
+        return std::nan("");
+    }
+    std::memcpy(buffer, first, len);
+    buffer[len] = '\0';
+    char* end = nullptr;
+    double value = std::strtod(buffer, &end);
+    if (end != buffer + len) return std::nan("");
+    return value;
+}
+
+// Convert the characters in [first, last) to an int without
+// allocating. Empty, malformed or out of range fields become 0.
+inline int parse_int(const char* first, const char* last) {
+    const char* p = first;
+    bool negative = false;
+    if ((p != last) && ((*p == '-') || (*p == '+'))) {
+        negative = (*p == '-');
+        ++p;
+    }
+    // wide enough that one more digit past the int range can't wrap
+    std::int64_t value = 0;
+    for (; (p != last) && (*p >= '0') && (*p <= '9'); ++p) {
+        value = value * 10 + (*p - '0');
+        if (value > INT_MAX) return 0;
+    }
+    if (p != last) return 0;
+    return static_cast<int>(negative ? -value : value);
+}
+
+// Return the next line of buffer starting at pos, with any trailing
+// carriage return removed, and advance pos past its newline.
+inline std::string_view next_line(std::string_view buffer, std::size_t& pos) {
+    std::size_t end = buffer.find('\n', pos);
+    if (end == std::string_view::npos) end = buffer.size();
+    std::string_view line = buffer.substr(pos, end - pos);
+    if ((!line.empty()) && (line.back() == '\r')) line.remove_suffix(1);
+    pos = end + 1;
+    return line;
+}
+
+// Return everything in buffer after its header line
+inline std::string_view skip_header(std::string_view buffer) {
+    std::size_t pos = 0;
+    next_line(buffer, pos);
+    return buffer.substr(std::min(pos, buffer.size()));
+}
+
+// Offset just past the last newline of buffer, i.e. the size of its
+// complete rows, or 0 if it has none
+inline std::size_t complete_rows_size(std::string_view buffer) {
+    const std::size_t last_newline = buffer.rfind('\n');
+    return (last_newline == std::string_view::npos) ? 0 : last_newline + 1;
+}
+
+// Count the number of non-empty rows in a header-less buffer
+inline std::ptrdiff_t count_rows(std::string_view rows) {
+    std::ptrdiff_t n_rows = 0;
+    std::size_t pos = 0;
+    while (pos < rows.size()) {
+        if (!next_line(rows, pos).empty()) ++n_rows;
+    }
+    return n_rows;
+}
+
+}  // namespace fw21::text
+
+#endif
@@ -0,0 +1,249 @@
+// Headless batch runner for the dead fuel moisture models.
+//
+// Loads FW21 and mesonet CSV files (or directories of *.fw21 files),
+// runs every dead fuel size class over every station on all cores, and
+// writes one CSV of fuel moisture and fuel temperature per station as
+// soon as its size classes are done.
+//
+// usage: NFDRSCLI [-o out_dir] [-j n_threads] [--cache]
+//                 [--result-cache dir] [--trace trace.json] input...
+#include <NFDRSGUI/FW21Decoder.h>
+#include <NFDRSGUI/FileLoader.h>
+#include <NFDRSGUI/ModelRunners.h>
+#include <NFDRSGUI/Profiler.h>
+#include <NFDRSGUI/ResultCache.h>
+#include <NFDRSGUI/Scheduler.h>
+#include <NFDRSGUI/StationStore.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t n_classes = std::size(nfdrs::dead_fuel_classes);
+
+struct Options {
+    std::string out_dir = ".";
+    unsigned n_threads = 0;
+    bool use_cache = false;
+    // Directory of dead fuel results reused across runs, if not empty
+    std::string result_cache;
+    // Chrome trace of the run, if not empty
+    std::string trace_path;
+    std::vector<std::string> inputs;
+};
+
+void print_usage() {
+    std::cerr << "usage: NFDRSCLI [-o out_dir] [-j n_threads] [--cache] "
+                 "[--result-cache dir] [--trace trace.json] input...\n"
+                 "  input      FW21 or mesonet CSV file, or a directory of "
+                 "*.fw21 files\n"
+                 "  -o         directory to write <station>_dfm.csv to "
+                 "(default .)\n"
+                 "  -j         worker threads (default one per core)\n"
+                 "  --cache    read and write <input>.nfc binary decode caches\n"
+                 "  --result-cache\n"
+                 "             directory of model results to reuse when the "
+                 "same data and\n"
+                 "             settings are run again\n"
+                 "  --trace    write a Chrome trace of the run (open in "
+                 "ui.perfetto.dev)"
+              << std::endl;
+}
+
+bool parse_args(int argc, char** argv, Options& options) {
+    for (int arg = 1; arg < argc; ++arg) {
+        const std::string_view flag = argv[arg];
+        if ((flag == "-o") && (arg + 1 < argc)) {
+            options.out_dir = argv[++arg];
+        } else if ((flag == "-j") && (arg + 1 < argc)) {
+            options.n_threads =
+                static_cast<unsigned>(std::max(0, std::atoi(argv[++arg])));
+        } else if (flag == "--cache") {
+            options.use_cache = true;
+        } else if ((flag == "--result-cache") && (arg + 1 < argc)) {
+            options.result_cache = argv[++arg];
+        } else if ((flag == "--trace") && (arg + 1 < argc)) {
+            options.trace_path = argv[++arg];
+        } else if ((flag == "-h") || (flag == "--help") ||
+                   (flag.substr(0, 1) == "-")) {
+            return false;
+        } else {
+            options.inputs.emplace_back(flag);
+        }
+    }
+    return !options.inputs.empty();
+}
+
+// Write the outputs of one station's runners, in dead_fuel_classes
+// order, as CSV. Returns false if the file can't be written.
+bool write_station(const std::string& path,
+                   const fw21::FW21Timeseries& series,
+                   const nfdrs::DeadFuelModelRunner* const runners[]) {
+    std::FILE* out = std::fopen(path.c_str(), "w");
+    if (out == nullptr) {
+        std::cerr << "Unable to write " << path << std::endl;
+        return false;
+    }
+
+    std::fprintf(out, "DateTime");
+    for (const auto& fuel_class : nfdrs::dead_fuel_classes) {
+        std::fprintf(out, ",%s_moisture,%s_temperature", fuel_class.name,
+                     fuel_class.name);
+    }
+    std::fprintf(out, "\n");
+
+    for (std::ptrdiff_t row = 0; row < series.NT; ++row) {
+        // date_time is the local time with the UTC offset added once more,
+        // as the original mktime decoder stored it, so it is not UTC and
+        // gets no zone suffix
+        const fw21::CivilTime time =
+            fw21::civil_from_unix_time(series.date_time[row]);
+        std::fprintf(out, "%04d-%02d-%02dT%02d:%02d:%02d", time.year,
+                     time.month, time.day, time.hour, time.minute,
+                     time.second);
+        for (std::size_t size_class = 0; size_class < n_classes;
+             ++size_class) {
+            std::fprintf(out, ",%.4f,%.4f",
+                         runners[size_class]->radial_moisture[row],
+                         runners[size_class]->fuel_temperature[row]);
+        }
+        std::fprintf(out, "\n");
+    }
+
+    const bool ok = (std::ferror(out) == 0);
+    std::fclose(out);
+    if (!ok) std::cerr << "Error writing " << path << std::endl;
+    return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_args(argc, argv, options)) {
+        print_usage();
+        return 1;
+    }
+    if (!options.trace_path.empty()) {
+#if NFDRSGUI_PROFILING
+        nfdrs::Tracer::instance().enable();
+        nfdrs::Tracer::instance().set_thread_name("main");
+#else
+        std::cerr << "Tracing was disabled at build time "
+                     "(NFDRSGUI_PROFILING=OFF)."
+                  << std::endl;
+#endif
+    }
+    // Results are written straight through to the directory rather than
+    // held in memory, so later runs find them
+    const bool use_result_cache = !options.result_cache.empty();
+    if (use_result_cache) {
+        nfdrs::ResultCache::instance().set_budget(0);
+        nfdrs::ResultCache::instance().set_spill_directory(
+            options.result_cache);
+    }
+    // Size the shared pool before anything else starts it
+    const unsigned n_threads =
+        nfdrs::Scheduler::instance(options.n_threads).size();
+
+    // Gather every input into one store, merging files of the same
+    // station
+    fw21::StationStore store;
+    for (const std::string& input : options.inputs) {
+        std::error_code err;
+        if (std::filesystem::is_directory(input, err)) {
+            store.load_directory(input, n_threads, fw21::Precision::Float64,
+                                 options.use_cache);
+        } else if (auto series = fw21::load_fw21_file(
+                       input, options.use_cache, n_threads)) {
+            store.insert(std::move(series), input);
+        }
+    }
+    if (store.empty()) {
+        std::cerr << "No station data could be loaded." << std::endl;
+        return 2;
+    }
+
+    // One task per station and size class, in station order with the
+    // slowest (largest) size class first. A station's outputs are only
+    // allocated once its tasks start, and the last of them to finish
+    // writes its CSV and frees them, so memory is bounded by the
+    // stations in flight rather than the whole store.
+    struct Station {
+        std::string name;
+        const fw21::FW21Timeseries* series = nullptr;
+        std::unique_ptr<nfdrs::DeadFuelModelRunner> runners[n_classes];
+        std::atomic<std::size_t> n_remaining{n_classes};
+    };
+    std::vector<Station> stations(store.size());
+    std::size_t station_idx = 0;
+    for (const auto& [station_id, series] : store) {
+        // stations without an ID are keyed by their source path
+        stations[station_idx].name =
+            series->station_id.empty()
+                ? std::filesystem::path(station_id).stem().string()
+                : station_id;
+        stations[station_idx].series = series.get();
+        ++station_idx;
+    }
+
+    std::error_code err;
+    std::filesystem::create_directories(options.out_dir, err);
+    std::atomic<int> status{0};
+    nfdrs::Scheduler::instance().parallel_for(
+        stations.size() * n_classes,
+        [&stations, &options, &status, use_result_cache](std::size_t idx) {
+            Station& station = stations[idx / n_classes];
+            const std::size_t size_class = n_classes - 1 - idx % n_classes;
+            const nfdrs::DeadFuelClass& fuel_class =
+                nfdrs::dead_fuel_classes[size_class];
+            auto runner = std::make_unique<nfdrs::DeadFuelModelRunner>(
+                fuel_class.radius, fuel_class.name, *station.series);
+            runner->apply_settings();
+            const std::uint64_t key =
+                use_result_cache ? runner->result_key(*station.series) : 0;
+            if ((!use_result_cache) || (!runner->restore_result(key))) {
+                runner->calc_dfm(*station.series, 0);
+                if (use_result_cache) runner->store_result(key);
+            }
+            station.runners[size_class] = std::move(runner);
+            if (station.n_remaining.fetch_sub(1, std::memory_order_acq_rel) !=
+                1) {
+                return;
+            }
+
+            const nfdrs::DeadFuelModelRunner* runners[n_classes];
+            for (std::size_t output = 0; output < n_classes; ++output) {
+                runners[output] = station.runners[output].get();
+            }
+            const std::filesystem::path path =
+                std::filesystem::path(options.out_dir) /
+                (station.name + "_dfm.csv");
+            if (!write_station(path.string(), *station.series, runners)) {
+                status = 3;
+            }
+            for (auto& runner : station.runners) runner.reset();
+        },
+        n_threads);
+
+    const nfdrs::Tracer& tracer = nfdrs::Tracer::instance();
+    if ((!options.trace_path.empty()) && (tracer.enabled()) &&
+        (!tracer.write_json(options.trace_path))) {
+        status = 3;
+    }
+
+    std::cout << "Processed " << store.size() << " stations" << std::endl;
+    return status;
+}
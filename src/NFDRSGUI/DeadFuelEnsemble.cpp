@@ -0,0 +1,153 @@
+#include <NFDRSGUI/FW21Decoder.h>
+#include <NFDRSGUI/ModelRunners.h>
+#include <NFDRSGUI/Scheduler.h>
+#include <deadfuelmoisture.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace nfdrs {
+
+// Replace members by one copy of each per value of field
+template <typename T>
+static void expand(std::vector<DeadFuelSettings>& members,
+                   const std::vector<T>& values, T DeadFuelSettings::*field) {
+    if (values.empty()) return;
+    std::vector<DeadFuelSettings> expanded;
+    expanded.reserve(members.size() * values.size());
+    for (const DeadFuelSettings& member : members) {
+        for (const T& value : values) {
+            expanded.push_back(member);
+            expanded.back().*field = value;
+        }
+    }
+    members = std::move(expanded);
+}
+
+template <typename T>
+static void pick(DeadFuelSettings& member, const std::vector<T>& values,
+                 T DeadFuelSettings::*field, std::mt19937& rng) {
+    if (values.empty()) return;
+    std::uniform_int_distribution<std::size_t> idx(0, values.size() - 1);
+    member.*field = values[idx(rng)];
+}
+
+std::vector<DeadFuelSettings> DeadFuelSweep::grid(
+    const DeadFuelSettings& base) const {
+    std::vector<DeadFuelSettings> members = {base};
+    expand(members, random_seeds, &DeadFuelSettings::random_seed);
+    expand(members, stick_nodes, &DeadFuelSettings::stick_nodes);
+    expand(members, moisture_steps, &DeadFuelSettings::moisture_steps);
+    expand(members, diffusivity_steps, &DeadFuelSettings::diffusivity_steps);
+    expand(members, adsorption_rates, &DeadFuelSettings::adsorption_rate);
+    expand(members, desorption_rates, &DeadFuelSettings::desorption_rate);
+    return members;
+}
+
+std::vector<DeadFuelSettings> DeadFuelSweep::sample(
+    const DeadFuelSettings& base, std::size_t n_members, unsigned seed) const {
+    std::mt19937 rng(seed);
+    std::vector<DeadFuelSettings> members(n_members, base);
+    for (DeadFuelSettings& member : members) {
+        pick(member, random_seeds, &DeadFuelSettings::random_seed, rng);
+        pick(member, stick_nodes, &DeadFuelSettings::stick_nodes, rng);
+        pick(member, moisture_steps, &DeadFuelSettings::moisture_steps, rng);
+        pick(member, diffusivity_steps, &DeadFuelSettings::diffusivity_steps,
+             rng);
+        pick(member, adsorption_rates, &DeadFuelSettings::adsorption_rate,
+             rng);
+        pick(member, desorption_rates, &DeadFuelSettings::desorption_rate,
+             rng);
+    }
+    return members;
+}
+
+void DeadFuelEnvelope::resize(std::size_t n_rows) {
+    min.resize(n_rows);
+    p10.resize(n_rows);
+    median.resize(n_rows);
+    p90.resize(n_rows);
+    max.resize(n_rows);
+}
+
+// Linearly interpolated quantile q of the n sorted values
+static double quantile(const double* sorted, std::size_t n, double q) {
+    const double pos = q * static_cast<double>(n - 1);
+    const std::size_t lower = static_cast<std::size_t>(pos);
+    if (lower + 1 >= n) return sorted[n - 1];
+    const double frac = pos - static_cast<double>(lower);
+    return sorted[lower] + frac * (sorted[lower + 1] - sorted[lower]);
+}
+
+void DeadFuelEnsemble::run(std::vector<DeadFuelSettings> new_members,
+                           double radius, const std::string& name,
+                           const fw21::FW21Timeseries& data) {
+    cancel();
+    members = std::move(new_members);
+    n_done = 0;
+    moisture.resize(static_cast<std::size_t>(data.NT));
+    process_task = Scheduler::instance().submit(
+        [this, radius, name, &data]() { calc(radius, name, data); });
+}
+
+void DeadFuelEnsemble::calc(double radius, const std::string& name,
+                            const fw21::FW21Timeseries& data) {
+    const std::size_t n_members = members.size();
+    if (n_members == 0) return;
+
+    std::vector<std::unique_ptr<DeadFuelMoisture>> models(n_members);
+    for (std::size_t member = 0; member < n_members; ++member) {
+        models[member] = std::make_unique<DeadFuelMoisture>(radius, name);
+        apply_dead_fuel_settings(*models[member], members[member]);
+    }
+
+    // block_rows values of every member, member major
+    std::vector<double> block(n_members * block_rows);
+    std::vector<double> row_values(n_members);
+    const fw21::ModelInputs& inputs = data.model_inputs();
+    Scheduler& scheduler = Scheduler::instance();
+    for (std::ptrdiff_t start = 0; start < data.NT; start += block_rows) {
+        if (cancel_requested.load(std::memory_order_relaxed)) return;
+        const std::ptrdiff_t count = std::min(block_rows, data.NT - start);
+
+        scheduler.parallel_for(n_members, [&](std::size_t member) {
+            DeadFuelMoisture& model = *models[member];
+            double* values = block.data() + member * block_rows;
+            for (std::ptrdiff_t row = 0; row < count; ++row) {
+                values[row] = update_dead_fuel(model, inputs, start + row)
+                                  ? model.medianRadialMoisture() * 100.0
+                                  : std::nan("");
+            }
+        });
+
+        // Reduce the block over the members, row by row
+        for (std::ptrdiff_t row = 0; row < count; ++row) {
+            std::size_t n_valid = 0;
+            for (std::size_t member = 0; member < n_members; ++member) {
+                const double value = block[member * block_rows + row];
+                if (!std::isnan(value)) row_values[n_valid++] = value;
+            }
+            const std::size_t idx = static_cast<std::size_t>(start + row);
+            if (n_valid == 0) {
+                moisture.min[idx] = moisture.p10[idx] = moisture.median[idx] =
+                    moisture.p90[idx] = moisture.max[idx] = std::nan("");
+                continue;
+            }
+            std::sort(row_values.begin(), row_values.begin() + n_valid);
+            moisture.min[idx] = row_values[0];
+            moisture.p10[idx] = quantile(row_values.data(), n_valid, 0.1);
+            moisture.median[idx] = quantile(row_values.data(), n_valid, 0.5);
+            moisture.p90[idx] = quantile(row_values.data(), n_valid, 0.9);
+            moisture.max[idx] = row_values[n_valid - 1];
+        }
+        n_done.store(start + count, std::memory_order_release);
+    }
+}
+
+}  // namespace nfdrs
@@ -0,0 +1,235 @@
+#include <NFDRSGUI/FW21Cache.h>
+#include <NFDRSGUI/FW21Decoder.h>
+#include <NFDRSGUI/FileLoader.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <system_error>
+
+namespace fw21 {
+
+using namespace cache;
+
+static_assert(sizeof(int) == 4, "int32 cache columns assume a 32-bit int");
+static_assert(sizeof(CacheHeader) % block_alignment == 0);
+
+// Meteorological columns, in ColumnId order from AIR_TEMPERATURE
+static MetColumn FW21Timeseries::*const met_columns[] = {
+    &FW21Timeseries::air_temperature, &FW21Timeseries::relative_humidity,
+    &FW21Timeseries::precipitation,   &FW21Timeseries::wind_speed,
+    &FW21Timeseries::wind_direction,  &FW21Timeseries::solar_radiation,
+    &FW21Timeseries::gust_speed,      &FW21Timeseries::gust_direction};
+
+static ColumnType column_type(std::uint32_t id, Precision met_precision) {
+    switch (id) {
+        case DATE_TIME:
+            return COLUMN_FLOAT64;
+        case SNOW_FLAG:
+        case SPC_CAT:
+            return COLUMN_INT32;
+        default:
+            if (met_precision == Precision::Float32) return COLUMN_FLOAT32;
+            if (met_precision == Precision::Scaled16) return COLUMN_SCALED16;
+            return COLUMN_FLOAT64;
+    }
+}
+
+static std::size_t type_size(ColumnType type) {
+    switch (type) {
+        case COLUMN_INT32:
+            return sizeof(int);
+        case COLUMN_FLOAT32:
+            return sizeof(float);
+        case COLUMN_SCALED16:
+            return sizeof(std::int16_t);
+        default:
+            return sizeof(double);
+    }
+}
+
+// Raw storage of a column of ts_data
+static const void* column_data(const FW21Timeseries& ts_data,
+                               std::uint32_t id) {
+    switch (id) {
+        case DATE_TIME:
+            return ts_data.date_time.data();
+        case SNOW_FLAG:
+            return ts_data.snow_flag.data();
+        case SPC_CAT:
+            return ts_data.spc_cat.data();
+        default:
+            return (ts_data.*met_columns[id - AIR_TEMPERATURE]).raw();
+    }
+}
+
+static void* column_data(FW21Timeseries& ts_data, std::uint32_t id) {
+    return const_cast<void*>(
+        column_data(static_cast<const FW21Timeseries&>(ts_data), id));
+}
+
+static std::uint64_t align_up(std::uint64_t offset) {
+    return (offset + block_alignment - 1) & ~(block_alignment - 1);
+}
+
+// Size and modification time of the cache's source file
+static bool source_stamp(const std::string& source_path,
+                         std::uint64_t& size, std::int64_t& mtime) {
+    std::error_code err;
+    size = std::filesystem::file_size(source_path, err);
+    if (err) return false;
+    auto write_time = std::filesystem::last_write_time(source_path, err);
+    if (err) return false;
+    mtime = static_cast<std::int64_t>(write_time.time_since_epoch().count());
+    return true;
+}
+
+std::string fw21_cache_path(const std::string& source_path) {
+    return source_path + ".nfc";
+}
+
+bool write_fw21_cache(const FW21Timeseries& ts_data,
+                      const std::string& cache_path,
+                      const std::string& source_path) {
+    CacheHeader header = {};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.byte_order_mark = byte_order_mark;
+    header.n_rows = ts_data.NT;
+    header.consumed_bytes = ts_data.consumed_bytes;
+    header.partial_last_row = ts_data.partial_last_row ? 1 : 0;
+    header.n_columns = N_COLUMNS;
+    header.met_precision = static_cast<std::uint32_t>(ts_data.met_precision());
+    ts_data.station_id.copy(header.station_id, sizeof(header.station_id) - 1);
+    if (!source_stamp(source_path, header.source_size, header.source_mtime)) {
+        return false;
+    }
+
+    // Lay out the column directory and the aligned blocks behind it
+    CacheColumn directory[N_COLUMNS];
+    std::uint64_t offset = align_up(sizeof(header) + sizeof(directory));
+    for (std::uint32_t id = 0; id < N_COLUMNS; ++id) {
+        const ColumnType type = column_type(id, ts_data.met_precision());
+        directory[id].id = id;
+        directory[id].type = type;
+        directory[id].n_bytes = ts_data.NT * type_size(type);
+        directory[id].offset = offset;
+        offset = align_up(offset + directory[id].n_bytes);
+    }
+
+    const std::string tmp_path = cache_path + ".tmp";
+    std::ofstream outfile(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!outfile) return false;
+
+    static const char padding[block_alignment] = {};
+    std::uint64_t written = 0;
+    auto write_block = [&](const void* data, std::uint64_t n_bytes,
+                           std::uint64_t at) {
+        outfile.write(padding, at - written);
+        outfile.write(static_cast<const char*>(data), n_bytes);
+        written = at + n_bytes;
+    };
+
+    write_block(&header, sizeof(header), 0);
+    write_block(directory, sizeof(directory), sizeof(header));
+    for (std::uint32_t id = 0; id < N_COLUMNS; ++id) {
+        write_block(column_data(ts_data, id), directory[id].n_bytes,
+                    directory[id].offset);
+    }
+    outfile.close();
+
+    std::error_code err;
+    if (!outfile) {
+        std::filesystem::remove(tmp_path, err);
+        return false;
+    }
+    std::filesystem::rename(tmp_path, cache_path, err);
+    if (err) {
+        std::cerr << "Unable to write cache " << cache_path << std::endl;
+        std::filesystem::remove(tmp_path, err);
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<FW21Timeseries> read_fw21_cache(
+    const std::string& cache_path, const std::string& source_path,
+    Precision met_precision) {
+    std::error_code err;
+    if (!std::filesystem::exists(cache_path, err)) return nullptr;
+
+    MappedFile mapping(cache_path);
+    if ((!mapping.is_open()) || (mapping.size() < sizeof(CacheHeader))) {
+        return nullptr;
+    }
+    const char* base = mapping.view().data();
+
+    CacheHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if ((std::memcmp(header.magic, magic, sizeof(magic)) != 0) ||
+        (header.version != version) ||
+        (header.byte_order_mark != byte_order_mark) ||
+        (header.n_columns != N_COLUMNS) || (header.n_rows < 0) ||
+        (header.consumed_bytes > header.source_size) ||
+        (header.met_precision !=
+         static_cast<std::uint32_t>(met_precision))) {
+        return nullptr;
+    }
+
+    // A cache is only good for as long as its source is unchanged
+    std::uint64_t source_size;
+    std::int64_t source_mtime;
+    if ((!source_stamp(source_path, source_size, source_mtime)) ||
+        (source_size != header.source_size) ||
+        (source_mtime != header.source_mtime)) {
+        return nullptr;
+    }
+
+    CacheColumn directory[N_COLUMNS];
+    if (mapping.size() < sizeof(header) + sizeof(directory)) return nullptr;
+    std::memcpy(directory, base + sizeof(header), sizeof(directory));
+
+    // Check that every block lies inside the mapping before allocating,
+    // so a corrupt n_rows is rejected rather than allocated
+    const std::uint64_t n_rows = static_cast<std::uint64_t>(header.n_rows);
+    for (std::uint32_t id = 0; id < N_COLUMNS; ++id) {
+        const CacheColumn& column = directory[id];
+        const ColumnType type = column_type(id, met_precision);
+        if ((column.id != id) || (column.type != type) ||
+            (n_rows > mapping.size() / type_size(type)) ||
+            (column.n_bytes != n_rows * type_size(type)) ||
+            (column.offset % block_alignment != 0) ||
+            (column.offset > mapping.size()) ||
+            (column.n_bytes > mapping.size() - column.offset)) {
+            return nullptr;
+        }
+    }
+
+    // The blocks are already in their in-memory representation
+    auto ts_data =
+        std::make_unique<FW21Timeseries>(header.n_rows, met_precision);
+    ts_data->resize(header.n_rows);
+    for (std::uint32_t id = 0; id < N_COLUMNS; ++id) {
+        std::memcpy(column_data(*ts_data, id), base + directory[id].offset,
+                    directory[id].n_bytes);
+    }
+
+    header.station_id[sizeof(header.station_id) - 1] = '\0';
+    ts_data->station_id = header.station_id;
+    ts_data->consumed_bytes = header.consumed_bytes;
+    // consumed_bytes covers the header line once it is complete
+    ts_data->header_consumed = (header.consumed_bytes > 0);
+    ts_data->partial_last_row = (header.partial_last_row != 0);
+    // spc_cat is stored, only its spans aren't
+    ts_data->calc_fire_cat_spans();
+
+    return ts_data;
+}
+
+}  // namespace fw21
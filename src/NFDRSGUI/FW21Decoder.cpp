@@ -1,213 +1,627 @@
 #include <NFDRSGUI/FW21Decoder.h>
+#include <NFDRSGUI/Profiler.h>
+#include <NFDRSGUI/Scheduler.h>
+#include <NFDRSGUI/TextParsing.h>
 
 #include <algorithm>
-#include <chrono>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <ctime>
-#include <iomanip>
 #include <iostream>
-#include <sstream>
-#include <string>
+#include <memory>
+#include <new>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 namespace fw21 {
 
-std::time_t parse_datetime_to_unix_time(const std::string& datetime_str) {
-    std::tm tm = {};
-    std::istringstream ss(datetime_str);
+using namespace text;
 
-    // Parse the datetime part (excluding the timezone)
-    ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
+// Days since 1970-01-01 for a proleptic Gregorian calendar date, using
+// only integer arithmetic (H. Hinnant's days_from_civil).
+static std::int64_t days_from_civil(std::int64_t year, unsigned month,
+                                    unsigned day) {
+    year -= (month <= 2);
+    const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 +
+                         day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
 
-    if (ss.fail()) {
-        std::cerr << "Error parsing datetime string." << std::endl;
-        return -1;
+// Inverse of days_from_civil (H. Hinnant's civil_from_days)
+static void civil_from_days(std::int64_t days, int& year, int& month,
+                            int& day) {
+    days += 719468;
+    const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe =
+        (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year = static_cast<int>(static_cast<std::int64_t>(yoe) + era * 400 +
+                            (month <= 2));
+}
+
+// Read n ASCII digits starting at str. Returns -1 if any of them is
+// not a digit.
+static int read_digits(const char* str, int n) {
+    int value = 0;
+    for (int i = 0; i < n; ++i) {
+        const unsigned digit = static_cast<unsigned char>(str[i]) - '0';
+        if (digit > 9) return -1;
+        value = value * 10 + static_cast<int>(digit);
     }
+    return value;
+}
 
-    // Convert tm to time_t (UTC time)
-    std::time_t utc_time = std::mktime(&tm);
-    std::time_t loc_time = std::mktime(&tm);
-    if (utc_time == -1) {
-        std::cerr << "Error converting tm to time_t." << std::endl;
-        return -1;
+bool DateTimeDecoder::decode(std::string_view datetime_str,
+                             std::time_t& unix_time) {
+    // yyyy-mm-ddThh:mm:ss is the minimum we accept
+    if (datetime_str.size() < 19) return false;
+    const char* str = datetime_str.data();
+
+    // Only redo the calendar arithmetic when the date changes
+    if (!m_day_valid || (std::memcmp(str, m_day, sizeof(m_day)) != 0)) {
+        if ((str[4] != '-') || (str[7] != '-')) return false;
+        const int year = read_digits(str, 4);
+        const int month = read_digits(str + 5, 2);
+        const int day = read_digits(str + 8, 2);
+        if ((year < 0) || (month < 1) || (month > 12) || (day < 1) ||
+            (day > 31)) {
+            return false;
+        }
+        std::memcpy(m_day, str, sizeof(m_day));
+        m_day_seconds = days_from_civil(year, month, day) * 86400;
+        m_day_valid = true;
     }
 
-    // Now parse the timezone offset (e.g., -06:00)
-    int hours_offset = 0, minutes_offset = 0;
-    char sign;
-    std::string timezone_str =
-        datetime_str.substr(19);  // Extract the timezone part
+    if ((str[10] != 'T') || (str[13] != ':') || (str[16] != ':')) {
+        return false;
+    }
+    const int hour = read_digits(str + 11, 2);
+    const int minute = read_digits(str + 14, 2);
+    const int second = read_digits(str + 17, 2);
+    if ((hour < 0) || (minute < 0) || (second < 0)) return false;
 
-    std::istringstream timezone_stream(timezone_str);
-    timezone_stream >> sign >> hours_offset;
-    timezone_stream.ignore(1);  // Skip the colon
-    timezone_stream >> minutes_offset;
+    // The UTC offset almost never changes within a file, so it is
+    // cached as well. A missing offset or 'Z' means UTC.
+    std::string_view offset = datetime_str.substr(19);
+    if ((offset.size() != m_offset_size) ||
+        (std::memcmp(offset.data(), m_offset, offset.size()) != 0)) {
+        std::int64_t offset_seconds = 0;
+        if ((offset.empty()) || (offset == "Z")) {
+            offset_seconds = 0;
+        } else if ((offset.size() == 6) &&
+                   ((offset[0] == '+') || (offset[0] == '-')) &&
+                   (offset[3] == ':')) {
+            const int hours_offset = read_digits(offset.data() + 1, 2);
+            const int minutes_offset = read_digits(offset.data() + 4, 2);
+            if ((hours_offset < 0) || (minutes_offset < 0)) return false;
+            offset_seconds = (hours_offset * 3600) + (minutes_offset * 60);
+            if (offset[0] == '-') offset_seconds = -offset_seconds;
+        } else {
+            return false;
+        }
+        std::memcpy(m_offset, offset.data(), offset.size());
+        m_offset_size = offset.size();
+        m_offset_seconds = offset_seconds;
+    }
+
+    // Adjust the time based on the timezone offset. This matches what
+    // the previous mktime based decoder produced when TZ=UTC.
+    unix_time = static_cast<std::time_t>(m_day_seconds + hour * 3600 +
+                                         minute * 60 + second +
+                                         m_offset_seconds);
+    return true;
+}
 
-    if (timezone_stream.fail()) {
-        std::cerr << "Error parsing timezone offset." << std::endl;
+std::time_t parse_datetime_to_unix_time(std::string_view datetime_str) {
+    thread_local DateTimeDecoder decoder;
+    std::time_t unix_time = -1;
+    if (!decoder.decode(datetime_str, unix_time)) {
+        std::cerr << "Error parsing datetime string." << std::endl;
         return -1;
     }
+    return unix_time;
+}
 
-    // Adjust the time based on the timezone offset
-    int offset_seconds = (hours_offset * 3600) + (minutes_offset * 60);
-    if (sign == '-') {
-        loc_time -= offset_seconds;
-    } else {
-        loc_time += offset_seconds;
+CivilTime civil_from_unix_time(double unix_time) {
+    const std::int64_t seconds =
+        static_cast<std::int64_t>(std::floor(unix_time));
+    // floor division, so times before 1970 land on the right day
+    std::int64_t days = seconds / 86400;
+    std::int64_t day_seconds = seconds % 86400;
+    if (day_seconds < 0) {
+        day_seconds += 86400;
+        days -= 1;
     }
 
-    return loc_time;
+    CivilTime civil;
+    civil_from_days(days, civil.year, civil.month, civil.day);
+    civil.hour = static_cast<int>(day_seconds / 3600);
+    civil.minute = static_cast<int>(day_seconds % 3600 / 60);
+    civil.second = static_cast<int>(day_seconds % 60);
+    return civil;
 }
 
-void parse_row(FW21Timeseries& ts_data, const std::string_view buffer,
-               const char delimiter = ',') {
-    std::ptrdiff_t row_start = 0;
-    std::ptrdiff_t row_end = 0;
-    std::ptrdiff_t row_idx = 0;
-    std::ptrdiff_t item_size = 0;
+// Column order of an FW21 data row
+enum FW21Column {
+    FW21_STATION_ID = 0,
+    FW21_DATE_TIME,
+    FW21_AIR_TEMPERATURE,
+    FW21_RELATIVE_HUMIDITY,
+    FW21_PRECIPITATION,
+    FW21_WIND_SPEED,
+    FW21_WIND_DIRECTION,
+    FW21_GUST_SPEED,
+    FW21_GUST_DIRECTION,
+    FW21_SNOW_FLAG,
+    FW21_SOLAR_RADIATION,
+    FW21_N_COLUMNS
+};
 
-    while ((row_end = buffer.find(delimiter, row_start)) !=
-           std::string_view::npos) {
-        std::string element(buffer.substr(row_start, row_end - row_start));
-        size_t idx;
-        switch (row_idx) {
-            // Date-Time
-            case 1: {
-                // handle converting string to UNIX timestamp
-                std::time_t unix_time = parse_datetime_to_unix_time(element);
-                ts_data.date_time.push_back(static_cast<double>(unix_time));
-                break;
-            }
+// Parse a single data row (without its line terminator) in one pass,
+// converting every field in place and appending it to the reserved
+// columns of ts_data. Missing trailing fields are filled with NaN so
+// that a short row still adds a value to every column.
+static void parse_row(FW21Timeseries& ts_data, DateTimeDecoder& decoder,
+                      const std::string_view row, const char delimiter = ',') {
+    const char* field = row.data();
+    const char* const row_end = row.data() + row.size();
 
-            // Temperature
-            case 2: {
-                double val =
-                    (element != "") ? std::stod(element, &idx) : std::nan("");
-                ts_data.air_temperature.push_back(val);
-                break;
-            }
+    double values[FW21_N_COLUMNS];
+    int snow_flag = 0;
+    std::time_t unix_time = -1;
 
-            // Relative Humidity
-            case 3: {
-                double val =
-                    (element != "") ? std::stod(element, &idx) : std::nan("");
-                ts_data.relative_humidity.push_back(val);
-                break;
-            }
+    for (int col = 0; col < FW21_N_COLUMNS; ++col) {
+        const void* found = std::memchr(field, delimiter, row_end - field);
+        const char* field_end =
+            (found != nullptr) ? static_cast<const char*>(found) : row_end;
 
-            // Precipitation
-            case 4: {
-                double val =
-                    (element != "") ? std::stod(element, &idx) : std::nan("");
-                ts_data.precipitation.push_back(val);
+        switch (col) {
+            case FW21_STATION_ID:
+                // a file describes a single station; keep the first ID
+                if ((ts_data.station_id.empty()) && (field != field_end)) {
+                    ts_data.station_id.assign(field, field_end);
+                }
                 break;
-            }
-
-            // Wind Speed
-            case 5: {
-                double val =
-                    (element != "") ? std::stod(element, &idx) : std::nan("");
-                ts_data.wind_speed.push_back(val);
+            case FW21_DATE_TIME:
+                if (!decoder.decode(std::string_view(field, field_end - field),
+                                    unix_time)) {
+                    unix_time = -1;
+                }
                 break;
-            }
-
-            // Wind Direction
-            case 6: {
-                double val =
-                    (element != "") ? std::stod(element, &idx) : std::nan("");
-                ts_data.wind_direction.push_back(val);
+            case FW21_SNOW_FLAG:
+                snow_flag = parse_int(field, field_end);
                 break;
-            }
-
-            // Gust Speed
-            case 7: {
-                double val =
-                    (element != "") ? std::stod(element, &idx) : std::nan("");
-                ts_data.gust_speed.push_back(val);
+            default:
+                values[col] = parse_double(field, field_end);
                 break;
-            }
+        }
 
-            // Gust Direction
-            case 8: {
-                double val =
-                    (element != "") ? std::stod(element, &idx) : std::nan("");
-                ts_data.gust_direction.push_back(val);
-                break;
-            }
+        // advance past the delimiter; once the row is exhausted every
+        // remaining field is empty
+        field = (field_end == row_end) ? row_end : field_end + 1;
+    }
 
-            // Snow flag
-            case 9: {
-                int val = (element != "") ? std::stoi(element, &idx) : 0;
-                ts_data.snow_flag.push_back(val);
-                break;
-            }
+    FW21Row parsed;
+    parsed.date_time = static_cast<double>(unix_time);
+    parsed.air_temperature = values[FW21_AIR_TEMPERATURE];
+    parsed.relative_humidity = values[FW21_RELATIVE_HUMIDITY];
+    parsed.precipitation = values[FW21_PRECIPITATION];
+    parsed.wind_speed = values[FW21_WIND_SPEED];
+    parsed.wind_direction = values[FW21_WIND_DIRECTION];
+    parsed.solar_radiation = values[FW21_SOLAR_RADIATION];
+    parsed.gust_speed = values[FW21_GUST_SPEED];
+    parsed.gust_direction = values[FW21_GUST_DIRECTION];
+    parsed.snow_flag = snow_flag;
+    ts_data.push_row(parsed);
+}
 
-            // Solar Radiation
-            case 10: {
-                double val =
-                    (element != "") ? std::stod(element, &idx) : std::nan("");
-                ts_data.solar_radiation.push_back(val);
-                break;
-            }
+// Decode a header-less buffer of rows, appending them to ts_data
+static void parse_rows_into(FW21Timeseries& ts_data, std::string_view rows) {
+    DateTimeDecoder decoder;
+    std::size_t pos = 0;
+    while (pos < rows.size()) {
+        std::string_view row = next_line(rows, pos);
+        if (!row.empty()) parse_row(ts_data, decoder, row);
+    }
+}
+
+// Decode a header-less buffer of complete rows into a new timeseries
+// whose arena is sized exactly to the number of rows.
+static FW21Timeseries parse_rows(std::string_view rows,
+                                 Precision met_precision) {
+    FW21Timeseries ts_data = FW21Timeseries(count_rows(rows), met_precision);
+    parse_rows_into(ts_data, rows);
+    return ts_data;
+}
+
+FW21Timeseries FW21Timeseries::decode_fw21(std::string_view data_buffer,
+                                           Precision met_precision) {
+    NFDRS_PROFILE_TIMER(timer, "decode_fw21", data_buffer.size() * 1e-6, "MB");
+    NFDRS_TRACE_SCOPE("decode", "decode_fw21");
+    // We want to skip the header string field
+    // and just parse the meteorological data
+    FW21Timeseries ts_data =
+        parse_rows(skip_header(data_buffer), met_precision);
+    ts_data.set_consumed(data_buffer);
+
+    ts_data.calc_fire_cat();
+
+    return ts_data;
+}
+
+FW21Timeseries FW21Timeseries::decode_fw21_parallel(
+    std::string_view data_buffer, unsigned n_threads,
+    Precision met_precision) {
+    // Chunks smaller than this aren't worth a thread
+    constexpr std::size_t min_chunk_size = 256 * 1024;
+
+    nfdrs::Scheduler& scheduler = nfdrs::Scheduler::instance();
+    if (n_threads == 0) n_threads = scheduler.size();
+    const std::string_view rows = skip_header(data_buffer);
+    const std::size_t n_chunks = std::min<std::size_t>(
+        std::max(n_threads, 1u), rows.size() / min_chunk_size);
+    if (n_chunks <= 1) return decode_fw21(data_buffer, met_precision);
+    NFDRS_PROFILE_TIMER(timer, "decode_fw21", data_buffer.size() * 1e-6, "MB");
+    NFDRS_TRACE_SCOPE("decode", "decode_fw21_parallel");
+
+    // Split at newline boundaries so every chunk holds whole rows
+    std::vector<std::string_view> chunks;
+    chunks.reserve(n_chunks);
+    std::size_t chunk_start = 0;
+    for (std::size_t chunk = 1; chunk <= n_chunks; ++chunk) {
+        std::size_t chunk_end = rows.size();
+        if (chunk < n_chunks) {
+            chunk_end = rows.find('\n', chunk * rows.size() / n_chunks);
+            chunk_end = (chunk_end == std::string_view::npos)
+                            ? rows.size()
+                            : chunk_end + 1;
         }
-        row_start = row_end + 1;
-        row_idx += 1;
-    }
-}
-
-FW21Timeseries FW21Timeseries::decode_fw21(std::string_view data_buffer) {
-    std::ptrdiff_t n_lines =
-        std::count(data_buffer.begin(), data_buffer.end(), '\n');
-    std::ptrdiff_t n_chars = data_buffer.size();
-    FW21Timeseries ts_data = FW21Timeseries(n_lines);
-
-    for (std::ptrdiff_t line_idx = 0; line_idx < n_lines; ++line_idx) {
-        std::ptrdiff_t row_start = 0;
-        std::ptrdiff_t row_end = data_buffer.find_first_of('\n');
-        std::ptrdiff_t row_size = row_end - row_start;
-        // we don't want to exceed the bounds of our
-        // string_view array
-        if (row_end < n_chars) {
-            std::string_view row(data_buffer.substr(row_start, row_size));
-
-            // We want to skip the header string field
-            // and just parse the meteorological data
-            if (line_idx > 0) {
-                parse_row(ts_data, row);
-            }
-            // advance the view forward
-            data_buffer.remove_prefix(row_size + 1);
+        if (chunk_end > chunk_start) {
+            chunks.push_back(
+                rows.substr(chunk_start, chunk_end - chunk_start));
+            chunk_start = chunk_end;
         }
     }
 
-    // parse the last row
-    std::string_view row(data_buffer.substr(0));
-    parse_row(ts_data, row);
+    // Decode every chunk into its own column segments
+    std::vector<std::unique_ptr<FW21Timeseries>> segments(chunks.size());
+    scheduler.parallel_for(
+        chunks.size(), [&segments, &chunks, met_precision](std::size_t chunk) {
+            NFDRS_TRACE_SCOPE("decode", "parse_rows");
+            segments[chunk] = std::make_unique<FW21Timeseries>(
+                parse_rows(chunks[chunk], met_precision));
+        });
+
+    // Merge the segments in file order
+    std::ptrdiff_t n_rows = 0;
+    for (const auto& segment : segments) n_rows += segment->NT;
+
+    FW21Timeseries ts_data = FW21Timeseries(n_rows, met_precision);
+    ts_data.station_id = segments.front()->station_id;
+    for (const auto& segment : segments) ts_data.append(*segment);
+    ts_data.set_consumed(data_buffer);
 
     ts_data.calc_fire_cat();
 
     return ts_data;
 }
 
-void FW21Timeseries::calc_fire_cat() {
-    for (std::ptrdiff_t idx = 0; idx < this->NT; ++idx) {
-        double wspd = this->wind_speed[idx];
-        double relh = this->relative_humidity[idx];
-        double tair = this->air_temperature[idx];
-        int spc_cat_val = 0;
-        if ((wspd >= 15) && (relh <= 25) && (tair >= 45)) {
-            spc_cat_val = 1;
+// Fixed point resolution of each meteorological column when stored at
+// Scaled16 precision, as the divisor applied to the stored integer.
+// These cover the physical range of each variable with headroom.
+static constexpr double temperature_divisor = 100.0;  // 0.01 F
+static constexpr double humidity_divisor = 100.0;     // 0.01 %
+static constexpr double precip_divisor = 1000.0;      // 0.001 in
+static constexpr double speed_divisor = 100.0;        // 0.01 mph
+static constexpr double direction_divisor = 10.0;     // 0.1 deg
+static constexpr double radiation_divisor = 10.0;     // 0.1 W/m2
+
+static std::size_t align_column(std::size_t n_bytes) {
+    constexpr std::size_t alignment = FW21Timeseries::column_alignment;
+    return (n_bytes + alignment - 1) & ~(alignment - 1);
+}
+
+// Size of an arena holding capacity rows
+static std::size_t arena_bytes(std::ptrdiff_t capacity,
+                               Precision met_precision) {
+    const std::size_t rows = static_cast<std::size_t>(capacity);
+    return align_column(rows * sizeof(double)) +
+           8 * align_column(rows * MetColumn::element_size(met_precision)) +
+           2 * align_column(rows * sizeof(int));
+}
+
+void FW21Timeseries::ArenaDeleter::operator()(std::byte* arena) const {
+    ::operator delete(arena, std::align_val_t(column_alignment));
+}
+
+FW21Timeseries::FW21Timeseries(std::ptrdiff_t NTIMES, Precision met_precision)
+    : m_met_precision(met_precision) {
+    const std::pair<MetColumn*, double> met_columns[] = {
+        {&air_temperature, temperature_divisor},
+        {&relative_humidity, humidity_divisor},
+        {&precipitation, precip_divisor},
+        {&wind_speed, speed_divisor},
+        {&wind_direction, direction_divisor},
+        {&solar_radiation, radiation_divisor},
+        {&gust_speed, speed_divisor},
+        {&gust_direction, direction_divisor}};
+    for (const auto& [column, divisor] : met_columns) {
+        column->m_precision = met_precision;
+        column->m_divisor =
+            (met_precision == Precision::Scaled16) ? divisor : 1.0;
+    }
+    reserve(NTIMES);
+}
+
+std::size_t FW21Timeseries::memory_usage() const {
+    return arena_bytes(m_capacity, m_met_precision);
+}
+
+void FW21Timeseries::reserve(std::ptrdiff_t n_rows) {
+    if (n_rows <= m_capacity) return;
+
+    const std::size_t met_size = MetColumn::element_size(m_met_precision);
+    std::byte* arena = static_cast<std::byte*>(
+        ::operator new(arena_bytes(n_rows, m_met_precision),
+                       std::align_val_t(column_alignment)));
+
+    // Lay the columns out back to back, each on its own cache line, and
+    // carry over the rows we already have
+    std::byte* cursor = arena;
+    auto place = [&](auto& column, std::size_t element_size) {
+        std::byte* block = cursor;
+        cursor += align_column(n_rows * element_size);
+        if (NT > 0) std::memcpy(block, column.m_data, NT * element_size);
+        column.m_data = reinterpret_cast<decltype(column.m_data)>(block);
+    };
+    place(date_time, sizeof(double));
+    place(air_temperature, met_size);
+    place(relative_humidity, met_size);
+    place(precipitation, met_size);
+    place(wind_speed, met_size);
+    place(wind_direction, met_size);
+    place(solar_radiation, met_size);
+    place(gust_speed, met_size);
+    place(gust_direction, met_size);
+    place(snow_flag, sizeof(int));
+    place(spc_cat, sizeof(int));
+
+    m_arena.reset(arena);
+    m_capacity = n_rows;
+}
+
+void FW21Timeseries::set_size(std::ptrdiff_t n_rows) {
+    NT = n_rows;
+    date_time.m_size = n_rows;
+    air_temperature.m_size = n_rows;
+    relative_humidity.m_size = n_rows;
+    precipitation.m_size = n_rows;
+    wind_speed.m_size = n_rows;
+    wind_direction.m_size = n_rows;
+    solar_radiation.m_size = n_rows;
+    gust_speed.m_size = n_rows;
+    gust_direction.m_size = n_rows;
+    snow_flag.m_size = n_rows;
+    spc_cat.m_size = n_rows;
+}
+
+void FW21Timeseries::resize(std::ptrdiff_t n_rows) {
+    reserve(n_rows);
+    set_size(n_rows);
+}
+
+void FW21Timeseries::push_row(const FW21Row& row) {
+    if (NT == m_capacity) reserve(std::max<std::ptrdiff_t>(64, 2 * NT));
+
+    const std::ptrdiff_t idx = NT;
+    date_time[idx] = row.date_time;
+    air_temperature.set(idx, row.air_temperature);
+    relative_humidity.set(idx, row.relative_humidity);
+    precipitation.set(idx, row.precipitation);
+    wind_speed.set(idx, row.wind_speed);
+    wind_direction.set(idx, row.wind_direction);
+    solar_radiation.set(idx, row.solar_radiation);
+    gust_speed.set(idx, row.gust_speed);
+    gust_direction.set(idx, row.gust_direction);
+    snow_flag[idx] = row.snow_flag;
+    spc_cat[idx] = row.spc_cat;
+    set_size(idx + 1);
+}
+
+FW21Row FW21Timeseries::row(std::ptrdiff_t idx) const {
+    FW21Row values;
+    values.date_time = date_time[idx];
+    values.air_temperature = air_temperature[idx];
+    values.relative_humidity = relative_humidity[idx];
+    values.precipitation = precipitation[idx];
+    values.wind_speed = wind_speed[idx];
+    values.wind_direction = wind_direction[idx];
+    values.solar_radiation = solar_radiation[idx];
+    values.gust_speed = gust_speed[idx];
+    values.gust_direction = gust_direction[idx];
+    values.snow_flag = snow_flag[idx];
+    values.spc_cat = spc_cat[idx];
+    return values;
+}
+
+void FW21Timeseries::append(const FW21Timeseries& other) {
+    if (other.m_met_precision != m_met_precision) {
+        reserve(NT + other.NT);
+        for (std::ptrdiff_t idx = 0; idx < other.NT; ++idx) {
+            push_row(other.row(idx));
+        }
+        return;
+    }
+
+    const std::ptrdiff_t start = NT;
+    resize(NT + other.NT);
+    const std::size_t met_size = MetColumn::element_size(m_met_precision);
+    auto copy = [&](auto& dst, const auto& src, std::size_t element_size) {
+        std::memcpy(static_cast<std::byte*>(static_cast<void*>(dst.m_data)) +
+                        start * element_size,
+                    src.m_data, other.NT * element_size);
+    };
+    copy(date_time, other.date_time, sizeof(double));
+    copy(air_temperature, other.air_temperature, met_size);
+    copy(relative_humidity, other.relative_humidity, met_size);
+    copy(precipitation, other.precipitation, met_size);
+    copy(wind_speed, other.wind_speed, met_size);
+    copy(wind_direction, other.wind_direction, met_size);
+    copy(solar_radiation, other.solar_radiation, met_size);
+    copy(gust_speed, other.gust_speed, met_size);
+    copy(gust_direction, other.gust_direction, met_size);
+    copy(snow_flag, other.snow_flag, sizeof(int));
+    copy(spc_cat, other.spc_cat, sizeof(int));
+}
+
+void FW21Timeseries::set_consumed(std::string_view data_buffer) {
+    consumed_bytes = complete_rows_size(data_buffer);
+    header_consumed = (data_buffer.find('\n') != std::string_view::npos);
+    // a header without a newline isn't a row
+    partial_last_row =
+        (NT > 0) && (consumed_bytes > 0) &&
+        (count_rows(data_buffer.substr(consumed_bytes)) > 0);
+}
+
+std::ptrdiff_t FW21Timeseries::append_fw21(std::string_view data_buffer) {
+    // the header was still incomplete when the buffer was last decoded
+    if (!header_consumed) {
+        const std::size_t header_end = data_buffer.find('\n');
+        if (header_end == std::string_view::npos) return 0;
+        consumed_bytes = std::max(consumed_bytes, header_end + 1);
+        header_consumed = true;
+    }
+    if (data_buffer.size() <= consumed_bytes) return 0;
+
+    // only consume up to and including the last complete row
+    std::string_view new_bytes = data_buffer.substr(consumed_bytes);
+    const std::size_t last_newline = new_bytes.rfind('\n');
+    if (last_newline == std::string_view::npos) return 0;
+    new_bytes = new_bytes.substr(0, last_newline + 1);
+
+    // the unterminated row decoded last time is now complete
+    if (partial_last_row) {
+        resize(NT - 1);
+        partial_last_row = false;
+        std::lock_guard<std::mutex> lock(m_inputs_cache->mutex);
+        m_inputs_cache->inputs = ModelInputs();
+    }
+
+    const std::ptrdiff_t start = NT;
+    parse_rows_into(*this, new_bytes);
+    consumed_bytes += new_bytes.size();
+
+    calc_fire_cat(start);
+
+    return NT - start;
+}
+
+// Fire weather category of a single row. The three criteria are nested,
+// so their sum is the highest one met. Comparisons against NaN are
+// false, leaving missing observations at 0. Bitwise & instead of && and
+// summing in double keep it free of branches and conversions, so the
+// loop below vectorizes.
+static inline double fire_cat(double wspd, double relh, double tair) {
+    const double elevated =
+        ((wspd >= 15) & (relh <= 25) & (tair >= 45)) ? 1.0 : 0.0;
+    const double critical =
+        ((wspd >= 20) & (relh <= 20) & (tair >= 50)) ? 1.0 : 0.0;
+    const double extreme =
+        ((wspd >= 30) & (relh <= 15) & (tair >= 60)) ? 1.0 : 0.0;
+    return elevated + critical + extreme;
+}
+
+void FW21Timeseries::calc_fire_cat(std::ptrdiff_t start) {
+    // Rows are done in blocks small enough for the decoded inputs to
+    // stay in L1 when the columns aren't stored as doubles
+    constexpr std::ptrdiff_t block_size = 512;
+    double wspd_block[block_size];
+    double relh_block[block_size];
+    double tair_block[block_size];
+
+    // Spans touching the recomputed rows are rebuilt, as a run that
+    // ended on the old last row may continue into the new ones
+    std::ptrdiff_t span_start = start;
+    while ((!fire_cat_spans.empty()) &&
+           (fire_cat_spans.back().end >= start)) {
+        span_start = std::min(span_start, fire_cat_spans.back().start);
+        fire_cat_spans.pop_back();
+    }
+    int run_cat = 0;
+    std::ptrdiff_t run_start = span_start;
+    for (std::ptrdiff_t idx = span_start; idx < start; ++idx) {
+        if (spc_cat[idx] != run_cat) {
+            if (run_cat > 0) {
+                fire_cat_spans.push_back({run_start, idx, run_cat});
+            }
+            run_cat = spc_cat[idx];
+            run_start = idx;
+        }
+    }
+
+    for (std::ptrdiff_t block = start; block < NT; block += block_size) {
+        const std::ptrdiff_t count = std::min(block_size, NT - block);
+        const double* wspd = wind_speed.data();
+        const double* relh = relative_humidity.data();
+        const double* tair = air_temperature.data();
+        if (m_met_precision == Precision::Float64) {
+            wspd += block;
+            relh += block;
+            tair += block;
+        } else {
+            wind_speed.decode(block, count, wspd_block);
+            relative_humidity.decode(block, count, relh_block);
+            air_temperature.decode(block, count, tair_block);
+            wspd = wspd_block;
+            relh = relh_block;
+            tair = tair_block;
         }
-        if ((wspd >= 20) && (relh <= 20) && (tair >= 50)) {
-            spc_cat_val = 2;
+
+        int* categories = spc_cat.data() + block;
+        for (std::ptrdiff_t idx = 0; idx < count; ++idx) {
+            categories[idx] =
+                static_cast<int>(fire_cat(wspd[idx], relh[idx], tair[idx]));
         }
-        if ((wspd >= 30) && (relh <= 15) && (tair >= 60)) {
-            spc_cat_val = 3;
+
+        // Record the runs while the block is still in cache
+        for (std::ptrdiff_t idx = 0; idx < count; ++idx) {
+            if (categories[idx] != run_cat) {
+                if (run_cat > 0) {
+                    fire_cat_spans.push_back(
+                        {run_start, block + idx, run_cat});
+                }
+                run_cat = categories[idx];
+                run_start = block + idx;
+            }
         }
+    }
+    if (run_cat > 0) fire_cat_spans.push_back({run_start, NT, run_cat});
+}
 
-        this->spc_cat[idx] = spc_cat_val;
+void FW21Timeseries::calc_fire_cat_spans() {
+    fire_cat_spans.clear();
+    int run_cat = 0;
+    std::ptrdiff_t run_start = 0;
+    for (std::ptrdiff_t idx = 0; idx < NT; ++idx) {
+        if (spc_cat[idx] != run_cat) {
+            if (run_cat > 0) {
+                fire_cat_spans.push_back({run_start, idx, run_cat});
+            }
+            run_cat = spc_cat[idx];
+            run_start = idx;
+        }
     }
+    if (run_cat > 0) fire_cat_spans.push_back({run_start, NT, run_cat});
 }
 
 }  // namespace fw21
@@ -0,0 +1,97 @@
+#include <NFDRSGUI/FW21Cache.h>
+#include <NFDRSGUI/FW21Decoder.h>
+#include <NFDRSGUI/FileLoader.h>
+#include <NFDRSGUI/MesonetDecoder.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace fw21 {
+
+MappedFile::MappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Unable to open " << path << std::endl;
+        return;
+    }
+
+    struct stat file_info;
+    if ((fstat(fd, &file_info) != 0) || (file_info.st_size <= 0)) {
+        std::cerr << "Unable to read " << path << std::endl;
+        close(fd);
+        return;
+    }
+
+    const std::size_t size = static_cast<std::size_t>(file_info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps its own reference to the file
+    close(fd);
+    if (data == MAP_FAILED) {
+        std::cerr << "Unable to map " << path << std::endl;
+        return;
+    }
+
+    // The decoder reads each chunk front to back exactly once
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    m_data = data;
+    m_size = size;
+}
+
+MappedFile::~MappedFile() {
+    if (m_data != nullptr) munmap(m_data, m_size);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)),
+      m_size(std::exchange(other.m_size, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        if (m_data != nullptr) munmap(m_data, m_size);
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+FW21Timeseries decode_station_data(std::string_view data_buffer,
+                                   unsigned n_threads,
+                                   Precision met_precision) {
+    if (is_mesonet_csv(data_buffer)) {
+        return decode_mesonet_csv(data_buffer, met_precision);
+    }
+    return FW21Timeseries::decode_fw21_parallel(data_buffer, n_threads,
+                                                met_precision);
+}
+
+std::unique_ptr<FW21Timeseries> load_fw21_file(const std::string& path,
+                                               bool use_cache,
+                                               unsigned n_threads,
+                                               Precision met_precision) {
+    const std::string cache_path = fw21_cache_path(path);
+    if (use_cache) {
+        std::unique_ptr<FW21Timeseries> cached =
+            read_fw21_cache(cache_path, path, met_precision);
+        if (cached) return cached;
+    }
+
+    MappedFile mapping(path);
+    if (!mapping.is_open()) return nullptr;
+
+    auto ts_data = std::make_unique<FW21Timeseries>(
+        decode_station_data(mapping.view(), n_threads, met_precision));
+    if (use_cache) write_fw21_cache(*ts_data, cache_path, path);
+
+    return ts_data;
+}
+
+}  // namespace fw21
@@ -0,0 +1,44 @@
+#include <NFDRSGUI/ModelRunners.h>
+#include <nfdrs4.h>
+
+#include <cmath>
+
+namespace nfdrs {
+
+// The indices are computed from moistures we supply, so the NFDRS4
+// drought and curing state only needs plausible defaults
+static constexpr double average_annual_precipitation = 30.0;
+static constexpr bool use_linear_transfer = true;
+static constexpr bool use_curing = true;
+static constexpr bool is_annual = false;
+static constexpr int kbdi_threshold = 100;
+
+void init_fire_danger(NFDRS4& model, const NFDRSSettings& settings,
+                      double latitude) {
+    model.Init(latitude, nfdrs_fuel_models[settings.fuel_model].code,
+               settings.slope_class, average_annual_precipitation,
+               use_linear_transfer, use_curing, is_annual, kbdi_threshold,
+               settings.obs_hour);
+}
+
+FireDangerIndices calc_fire_danger(NFDRS4& model, int slope_class,
+                                   const FireDangerInputs& in) {
+    const double missing = std::nan("");
+    if (std::isnan(in.mc1) || std::isnan(in.mc10) || std::isnan(in.mc100) ||
+        std::isnan(in.mc1000) || std::isnan(in.mc_herb) ||
+        std::isnan(in.mc_wood) || std::isnan(in.fuel_temperature) ||
+        std::isnan(in.wind_speed)) {
+        return {missing, missing, missing, missing};
+    }
+
+    model.iSetFuelMoistures(in.mc1, in.mc10, in.mc100, in.mc1000, in.mc_wood,
+                            in.mc_herb, in.fuel_temperature);
+    FireDangerIndices indices;
+    model.iCalcIndexes(static_cast<int>(std::lround(in.wind_speed)),
+                       slope_class, &indices.spread_component,
+                       &indices.energy_release, &indices.burning_index,
+                       &indices.ignition_component);
+    return indices;
+}
+
+}  // namespace nfdrs
@@ -0,0 +1,166 @@
+#include <NFDRSGUI/FW21Decoder.h>
+#include <NFDRSGUI/ModelRunners.h>
+#include <NFDRSGUI/Pipeline.h>
+#include <NFDRSGUI/Profiler.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace nfdrs {
+
+namespace {
+
+using Status = Pipeline::Status;
+
+// Whether a producer that has published produced rows must wait for the
+// indices to catch up
+bool window_full(std::ptrdiff_t produced, const NFDRSModelRunner& indices) {
+    return produced - indices.valid_rows() >=
+           NFDRSModelRunner::pipeline_window_rows;
+}
+
+// A stage stepping dfm from its first row, or copying its outputs from
+// the ResultCache
+Pipeline::Stage dead_fuel_stage(DeadFuelModelRunner& dfm,
+                                const fw21::FW21Timeseries& data,
+                                const NFDRSModelRunner& indices) {
+    return [&dfm, &data, &indices, key = std::uint64_t(0),
+            first_turn = true]() mutable {
+        if (first_turn) {
+            first_turn = false;
+            key = dfm.result_key(data);
+            if (dfm.restore_result(key)) return Status::Done;
+        }
+        const std::ptrdiff_t start = dfm.valid_rows();
+        if (window_full(start, indices)) return Status::Blocked;
+        NFDRS_TRACE_SCOPE_DETAIL("model", "calc_dfm", dfm.name.c_str());
+        const std::ptrdiff_t end = std::min(
+            start + NFDRSModelRunner::pipeline_chunk_rows, dfm.size);
+        if (dfm.step_rows(data.model_inputs(), start, end) < end) {
+            return Status::Done;
+        }
+        if (end < dfm.size) return Status::Progress;
+        dfm.store_result(key);
+        return Status::Done;
+    };
+}
+
+// A stage stepping lfm from its first row
+Pipeline::Stage live_fuel_stage(LiveFuelModelRunner& lfm,
+                                const fw21::FW21Timeseries& data,
+                                const NFDRSModelRunner& indices) {
+    return [&lfm, &data, &indices]() {
+        const std::ptrdiff_t start = lfm.valid_rows();
+        if (window_full(start, indices)) return Status::Blocked;
+        NFDRS_TRACE_SCOPE_DETAIL("model", "calc_lfm", lfm.name.c_str());
+        const std::ptrdiff_t end = std::min(
+            start + NFDRSModelRunner::pipeline_chunk_rows, lfm.size);
+        if (lfm.step_rows(data.model_inputs(), start, end) < end) {
+            return Status::Done;
+        }
+        return (end < lfm.size) ? Status::Progress : Status::Done;
+    };
+}
+
+}  // namespace
+
+void NFDRSModelRunner::run(const fw21::FW21Timeseries& data,
+                           DeadFuelModelRunner& dfm_1h,
+                           DeadFuelModelRunner& dfm_10h,
+                           DeadFuelModelRunner& dfm_100h,
+                           DeadFuelModelRunner& dfm_1000h,
+                           LiveFuelModelRunner& lfm_herb,
+                           LiveFuelModelRunner& lfm_woody) {
+    reset();
+    size = data.NT;
+    auto wind_speed = std::make_shared<std::vector<double>>(size);
+    data.wind_speed.decode(0, size, wind_speed->data());
+    inputs.resize(size);
+    energy_release.resize(size);
+    burning_index.resize(size);
+    ignition_component.resize(size);
+    spread_component.resize(size);
+    pipeline = std::make_shared<Pipeline>();
+    Pipeline* const graph = pipeline.get();
+    const std::array<DeadFuelModelRunner*, 4> dead_fuels = {
+        &dfm_1h, &dfm_10h, &dfm_100h, &dfm_1000h};
+    const std::array<LiveFuelModelRunner*, 2> live_fuels = {&lfm_herb,
+                                                            &lfm_woody};
+
+    // Start over the runners without a finished run, as stages feeding
+    // the indices
+    std::vector<std::size_t> producers;
+    for (DeadFuelModelRunner* dfm : dead_fuels) {
+        if ((dfm->finished()) && (!dfm->running())) continue;
+        dfm->cancel();
+        if (dfm->model->updates() > 0) dfm->reset();
+        dfm->apply_settings();
+        producers.push_back(
+            graph->add_stage(dead_fuel_stage(*dfm, data, *this)));
+    }
+    for (LiveFuelModelRunner* lfm : live_fuels) {
+        if ((lfm->finished()) && (!lfm->running())) continue;
+        lfm->reset();
+        lfm->apply_settings();
+        producers.push_back(
+            graph->add_stage(live_fuel_stage(*lfm, data, *this)));
+    }
+    applied_settings = settings;
+    init_fire_danger(*model, applied_settings,
+                     lfm_herb.applied_settings.latitude);
+
+    // The indices take each row once every runner has published it. A
+    // runner cancelled meanwhile will not publish the rest, so the whole
+    // pipeline is cancelled with it. Each turn that publishes rows wakes
+    // the producers held back by pipeline_window_rows.
+    const std::size_t indices = graph->add_stage(
+        [this, graph, dead_fuels, live_fuels, wind_speed, &data,
+         row = std::ptrdiff_t(0)]() mutable {
+            std::ptrdiff_t ready = std::min(row + pipeline_chunk_rows, size);
+            for (const DeadFuelModelRunner* dfm : dead_fuels) {
+                if (dfm->cancel_requested) {
+                    graph->cancel();
+                    return Status::Done;
+                }
+                ready = std::min(ready, dfm->valid_rows());
+            }
+            for (const LiveFuelModelRunner* lfm : live_fuels) {
+                if (lfm->cancel_requested) {
+                    graph->cancel();
+                    return Status::Done;
+                }
+                ready = std::min(ready, lfm->valid_rows());
+            }
+            const std::ptrdiff_t start = row;
+            const fw21::ModelInputs& model_inputs = data.model_inputs();
+            for (; row < ready; ++row) {
+                inputs[row] = {dead_fuels[0]->radial_moisture[row],
+                               dead_fuels[1]->radial_moisture[row],
+                               dead_fuels[2]->radial_moisture[row],
+                               dead_fuels[3]->radial_moisture[row],
+                               live_fuels[0]->moisture[row],
+                               live_fuels[1]->moisture[row],
+                               dead_fuels[0]->fuel_temperature[row],
+                               (*wind_speed)[row]};
+                calc_row(data, model_inputs, row);
+            }
+            n_done.store(row, std::memory_order_release);
+            if (row == size) return Status::Done;
+            return (row > start) ? Status::Progress : Status::Blocked;
+        });
+    for (std::size_t producer : producers) graph->connect(producer, indices);
+
+    process_task = graph->start().share();
+    for (DeadFuelModelRunner* dfm : dead_fuels) {
+        dfm->process_task = process_task;
+    }
+    for (LiveFuelModelRunner* lfm : live_fuels) {
+        lfm->process_task = process_task;
+    }
+}
+
+}  // namespace nfdrs
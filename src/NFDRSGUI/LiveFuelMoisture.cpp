@@ -0,0 +1,95 @@
+#include <NFDRSGUI/FW21Decoder.h>
+#include <NFDRSGUI/ModelRunners.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace nfdrs {
+
+// Index limits from Jolly et al. (2005), "A generalized, bioclimatic
+// index to predict foliar phenology in response to climate", Global
+// Change Biology 11, 619-632. These are also the GSI defaults of NFDRS
+// 2016.
+static constexpr double min_temperature_low = -2.0;  // deg C
+static constexpr double min_temperature_high = 5.0;
+static constexpr double vpd_low = 900.0;  // Pa
+static constexpr double vpd_high = 4100.0;
+static constexpr double daylength_low = 36000.0;  // s
+static constexpr double daylength_high = 39600.0;
+
+// 0 at or below low, 1 at or above high, linear in between
+static double ramp(double value, double low, double high) {
+    return std::clamp((value - low) / (high - low), 0.0, 1.0);
+}
+
+// Saturation vapor pressure deficit (Pa) at temperature (deg C) and
+// relative humidity (fraction), with the Tetens (1930) saturation vapor
+// pressure
+static double vapor_pressure_deficit(double temperature, double humidity) {
+    const double saturation =
+        610.78 * std::exp(17.27 * temperature / (temperature + 237.3));
+    return saturation * (1.0 - humidity);
+}
+
+static int day_of_year(int year, int month, int day) {
+    static constexpr int days_before[] = {0,   31,  59,  90,  120, 151,
+                                          181, 212, 243, 273, 304, 334};
+    const bool leap =
+        ((year % 4 == 0) && (year % 100 != 0)) || (year % 400 == 0);
+    return days_before[month - 1] + day + (((leap) && (month > 2)) ? 1 : 0);
+}
+
+// Seconds from sunrise to sunset at latitude (degrees) on day_of_year,
+// with the solar declination of Cooper (1969)
+static double daylength(double latitude, int day_of_year) {
+    constexpr double deg = 3.14159265358979323846 / 180.0;
+    const double declination =
+        23.45 * deg * std::sin(2.0 * 180.0 * deg * (284 + day_of_year) / 365);
+    const double cos_hour_angle = std::clamp(
+        -std::tan(latitude * deg) * std::tan(declination), -1.0, 1.0);
+    return 2.0 * std::acos(cos_hour_angle) / (15.0 * deg) * 3600.0;
+}
+
+GrowingSeasonIndex::GrowingSeasonIndex(double latitude, int averaging_days)
+    : m_latitude(latitude),
+      m_days(static_cast<std::size_t>(std::max(averaging_days, 1))) {}
+
+void GrowingSeasonIndex::close_day() {
+    if (m_n_hours == 0) return;
+    const double index =
+        ramp(m_min_temperature, min_temperature_low, min_temperature_high) *
+        (1.0 - ramp(m_vpd_sum / m_n_hours, vpd_low, vpd_high)) *
+        ramp(daylength(m_latitude, day_of_year(m_year, m_month, m_day)),
+             daylength_low, daylength_high);
+    m_days[m_next] = index;
+    m_next = (m_next + 1) % m_days.size();
+    m_n_days = std::min(m_n_days + 1, m_days.size());
+    double sum = 0.0;
+    for (std::size_t day = 0; day < m_n_days; ++day) sum += m_days[day];
+    m_average = sum / m_n_days;
+    m_vpd_sum = 0.0;
+    m_n_hours = 0;
+}
+
+bool GrowingSeasonIndex::update(const fw21::ModelInputs& inputs,
+                                std::ptrdiff_t i) {
+    if (!inputs.valid[i]) return false;
+    if ((inputs.day[i] != m_day) || (inputs.month[i] != m_month) ||
+        (inputs.year[i] != m_year)) {
+        close_day();
+        m_year = inputs.year[i];
+        m_month = inputs.month[i];
+        m_day = inputs.day[i];
+    }
+    const double temperature = inputs.air_temperature[i];
+    m_min_temperature = (m_n_hours == 0)
+                            ? temperature
+                            : std::min(m_min_temperature, temperature);
+    m_vpd_sum +=
+        vapor_pressure_deficit(temperature, inputs.relative_humidity[i]);
+    ++m_n_hours;
+    return true;
+}
+
+}  // namespace nfdrs
@@ -0,0 +1,199 @@
+#include <NFDRSGUI/FW21Decoder.h>
+#include <NFDRSGUI/MesonetDecoder.h>
+#include <NFDRSGUI/TextParsing.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+namespace fw21 {
+
+using namespace text;
+
+// Mesonet fields that have an FW21 counterpart
+enum MesonetField {
+    MESONET_DATE_TIME = 0,
+    MESONET_RELATIVE_HUMIDITY,
+    MESONET_AIR_TEMPERATURE,
+    MESONET_WIND_SPEED,
+    MESONET_WIND_DIRECTION,
+    MESONET_GUST_SPEED,
+    MESONET_RAIN_TOTAL,
+    MESONET_SOLAR_RADIATION,
+    MESONET_N_FIELDS
+};
+
+// Header names of the fields above, in MesonetField order
+static constexpr std::string_view field_names[MESONET_N_FIELDS] = {
+    "DateTime", "RELH", "TAIR", "WSPD", "WDIR", "WMAX", "RAIN", "SRAD"};
+static constexpr std::string_view station_field_name = "STID";
+
+static constexpr double mph_per_mps = 2.2369362920544;
+static constexpr double inches_per_mm = 1.0 / 25.4;
+// The mesonet flags missing or bad observations with values from -999
+// to -990
+static constexpr double missing_threshold = -990.0;
+
+// Calls visit(column, name) for every column name in a header line
+template <typename Visitor>
+static void for_each_column(std::string_view header, Visitor visit) {
+    int column = 0;
+    for (std::size_t start = 0; start <= header.size(); ++column) {
+        std::size_t end = header.find(',', start);
+        if (end == std::string_view::npos) end = header.size();
+        visit(column, header.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+bool is_mesonet_csv(std::string_view data_buffer) {
+    std::size_t pos = 0;
+    bool has_station = false;
+    for_each_column(next_line(data_buffer, pos),
+                    [&has_station](int, std::string_view name) {
+                        has_station |= (name == station_field_name);
+                    });
+    return has_station;
+}
+
+FW21Timeseries decode_mesonet_csv(std::string_view data_buffer,
+                                  Precision met_precision) {
+    // Map every column of the header to the field it holds, or -1
+    std::size_t pos = 0;
+    const std::string_view header = next_line(data_buffer, pos);
+    std::vector<int> column_fields;
+    int station_column = -1;
+    bool has_time = false;
+    for_each_column(header, [&](int column, std::string_view name) {
+        const auto* found =
+            std::find(std::begin(field_names), std::end(field_names), name);
+        const int field = (found != std::end(field_names))
+                              ? static_cast<int>(found - field_names)
+                              : -1;
+        if (name == station_field_name) station_column = column;
+        has_time |= (field == MESONET_DATE_TIME);
+        column_fields.push_back(field);
+    });
+    if (!has_time) {
+        std::cerr << "Mesonet CSV has no DateTime column." << std::endl;
+        return FW21Timeseries(0, met_precision);
+    }
+
+    // Decode every field into its own scratch column, as found in the
+    // file. Fields a row doesn't have stay missing.
+    const std::string_view rows = skip_header(data_buffer);
+    const std::ptrdiff_t n_rows = count_rows(rows);
+    std::vector<double> values(MESONET_N_FIELDS * n_rows,
+                               std::numeric_limits<double>::quiet_NaN());
+    auto field_values = [&values, n_rows](int field) {
+        return values.data() + field * n_rows;
+    };
+
+    FW21Timeseries ts_data = FW21Timeseries(n_rows, met_precision);
+    DateTimeDecoder decoder;
+    std::ptrdiff_t row_idx = 0;
+    pos = 0;
+    while (pos < rows.size()) {
+        const std::string_view row = next_line(rows, pos);
+        if (row.empty()) continue;
+
+        const char* field = row.data();
+        const char* const row_end = row.data() + row.size();
+        for (std::size_t col = 0; col < column_fields.size(); ++col) {
+            const void* found = std::memchr(field, ',', row_end - field);
+            const char* field_end =
+                (found != nullptr) ? static_cast<const char*>(found) : row_end;
+
+            const int target = column_fields[col];
+            if (target == MESONET_DATE_TIME) {
+                std::time_t unix_time = -1;
+                if (!decoder.decode(
+                        std::string_view(field, field_end - field),
+                        unix_time)) {
+                    unix_time = -1;
+                }
+                field_values(target)[row_idx] =
+                    static_cast<double>(unix_time);
+            } else if (target >= 0) {
+                field_values(target)[row_idx] =
+                    parse_double(field, field_end);
+            } else if ((static_cast<int>(col) == station_column) &&
+                       (ts_data.station_id.empty()) &&
+                       (field != field_end)) {
+                ts_data.station_id.assign(field, field_end);
+            }
+
+            if (field_end == row_end) break;
+            field = field_end + 1;
+        }
+        ++row_idx;
+    }
+
+    // Convert to FW21 units in one pass per column. Every loop is a
+    // straight line select or multiply-add, so each vectorizes.
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (int field = MESONET_RELATIVE_HUMIDITY; field < MESONET_N_FIELDS;
+         ++field) {
+        double* column = field_values(field);
+        for (std::ptrdiff_t idx = 0; idx < n_rows; ++idx) {
+            column[idx] =
+                (column[idx] <= missing_threshold) ? nan : column[idx];
+        }
+    }
+    double* tair = field_values(MESONET_AIR_TEMPERATURE);
+    for (std::ptrdiff_t idx = 0; idx < n_rows; ++idx) {
+        tair[idx] = tair[idx] * 1.8 + 32.0;
+    }
+    double* wspd = field_values(MESONET_WIND_SPEED);
+    double* gust = field_values(MESONET_GUST_SPEED);
+    for (std::ptrdiff_t idx = 0; idx < n_rows; ++idx) {
+        wspd[idx] *= mph_per_mps;
+        gust[idx] *= mph_per_mps;
+    }
+
+    // RAIN accumulates from 00Z. A drop means the total was reset, so
+    // the new total is all of this hour's rain. The first hour has
+    // nothing to difference against, and a missing neighbour leaves the
+    // hour missing.
+    const double* rain_total = field_values(MESONET_RAIN_TOTAL);
+    std::vector<double> rain(n_rows);
+    if (n_rows > 0) rain[0] = 0.0;
+    for (std::ptrdiff_t idx = 1; idx < n_rows; ++idx) {
+        const double total = rain_total[idx];
+        const double change = total - rain_total[idx - 1];
+        // NaN when either total is missing
+        const double hourly = (change < 0.0) ? total : change;
+        rain[idx] = hourly * inches_per_mm;
+    }
+
+    ts_data.resize(n_rows);
+    std::copy_n(field_values(MESONET_DATE_TIME), n_rows,
+                ts_data.date_time.data());
+    ts_data.air_temperature.encode(0, n_rows, tair);
+    ts_data.relative_humidity.encode(
+        0, n_rows, field_values(MESONET_RELATIVE_HUMIDITY));
+    ts_data.precipitation.encode(0, n_rows, rain.data());
+    ts_data.wind_speed.encode(0, n_rows, wspd);
+    ts_data.wind_direction.encode(0, n_rows,
+                                  field_values(MESONET_WIND_DIRECTION));
+    ts_data.solar_radiation.encode(0, n_rows,
+                                   field_values(MESONET_SOLAR_RADIATION));
+    ts_data.gust_speed.encode(0, n_rows, gust);
+    // the mesonet doesn't report a gust direction or snow
+    for (std::ptrdiff_t idx = 0; idx < n_rows; ++idx) {
+        ts_data.gust_direction.set(idx, nan);
+    }
+    std::fill_n(ts_data.snow_flag.data(), n_rows, 0);
+
+    ts_data.set_consumed(data_buffer);
+    ts_data.calc_fire_cat();
+
+    return ts_data;
+}
+
+}  // namespace fw21
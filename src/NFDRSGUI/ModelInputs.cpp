@@ -0,0 +1,89 @@
+#include <NFDRSGUI/FW21Decoder.h>
+#include <NFDRSGUI/ModelInputs.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+
+namespace fw21 {
+
+// Bit pattern of value, with every NaN mapped to the same one
+static std::uint64_t bits(double value) {
+    if (value != value) return 0x7ff8000000000000;
+    std::uint64_t word;
+    std::memcpy(&word, &value, sizeof(word));
+    return word;
+}
+
+void ModelInputs::extend(const FW21Timeseries& data) {
+    const std::ptrdiff_t start = NT;
+    const std::ptrdiff_t count = data.NT - start;
+    if (count <= 0) return;
+    const std::size_t n_rows = static_cast<std::size_t>(data.NT);
+    year.resize(n_rows);
+    month.resize(n_rows);
+    day.resize(n_rows);
+    hour.resize(n_rows);
+    minute.resize(n_rows);
+    second.resize(n_rows);
+    air_temperature.resize(n_rows);
+    relative_humidity.resize(n_rows);
+    solar_radiation.resize(n_rows);
+    precipitation.resize(n_rows);
+    valid.resize(n_rows);
+
+    double* tair = air_temperature.data() + start;
+    double* relh = relative_humidity.data() + start;
+    double* srad = solar_radiation.data() + start;
+    double* rain = precipitation.data() + start;
+    data.air_temperature.decode(start, count, tair);
+    data.relative_humidity.decode(start, count, relh);
+    data.solar_radiation.decode(start, count, srad);
+    data.precipitation.decode(start, count, rain);
+    std::uint8_t* ok = valid.data() + start;
+    for (std::ptrdiff_t row = 0; row < count; ++row) {
+        tair[row] = (tair[row] - 32.0) * (5. / 9.);
+        relh[row] = relh[row] / 100.0;
+        rain[row] = rain[row] * 2.54;
+        // NaN is the only value unequal to itself
+        ok[row] = (tair[row] == tair[row]) & (relh[row] == relh[row]) &
+                  (srad[row] == srad[row]) & (rain[row] == rain[row]);
+    }
+
+    for (std::ptrdiff_t row = start; row < data.NT; ++row) {
+        const CivilTime time_data = civil_from_unix_time(data.date_time[row]);
+        year[row] = static_cast<std::int16_t>(time_data.year);
+        month[row] = static_cast<std::uint8_t>(time_data.month);
+        day[row] = static_cast<std::uint8_t>(time_data.day);
+        hour[row] = static_cast<std::uint8_t>(time_data.hour);
+        minute[row] = static_cast<std::uint8_t>(time_data.minute);
+        second[row] = static_cast<std::uint8_t>(time_data.second);
+
+        // FNV-1a over 64-bit words rather than bytes
+        const std::uint64_t words[] = {
+            (static_cast<std::uint64_t>(time_data.year) << 40) ^
+                (static_cast<std::uint64_t>(time_data.month) << 32) ^
+                (static_cast<std::uint64_t>(time_data.day) << 24) ^
+                (static_cast<std::uint64_t>(time_data.hour) << 16) ^
+                (static_cast<std::uint64_t>(time_data.minute) << 8) ^
+                static_cast<std::uint64_t>(time_data.second),
+            bits(air_temperature[row]), bits(relative_humidity[row]),
+            bits(solar_radiation[row]), bits(precipitation[row])};
+        for (std::uint64_t word : words) {
+            hash = (hash ^ word) * 0x100000001b3;
+        }
+    }
+    NT = data.NT;
+}
+
+const ModelInputs& FW21Timeseries::model_inputs() const {
+    std::lock_guard<std::mutex> lock(m_inputs_cache->mutex);
+    ModelInputs& inputs = m_inputs_cache->inputs;
+    // rows are only ever appended; anything else starts over
+    if (inputs.NT > NT) inputs = ModelInputs();
+    inputs.extend(*this);
+    return inputs;
+}
+
+}  // namespace fw21
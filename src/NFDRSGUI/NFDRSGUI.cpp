@@ -1,6 +1,10 @@
 #include <NFDRSGUI/FW21Decoder.h>
+#include <NFDRSGUI/FileLoader.h>
+#include <NFDRSGUI/MesonetDecoder.h>
 #include <NFDRSGUI/ModelRunners.h>
 #include <NFDRSGUI/NFDRSGUI.h>
+#include <NFDRSGUI/Profiler.h>
+#include <NFDRSGUI/Scheduler.h>
 #include <deadfuelmoisture.h>
 #include <nfdrs4.h>
 
@@ -12,8 +16,10 @@
 #endif
 
 #include <atomic>
+#include <cstring>
 #include <ctime>
 #include <memory>
+#include <string>
 #include <thread>
 
 #include "imgui.h"
@@ -72,12 +78,12 @@ bool ShallIdleThisFrame_Emscripten(FPSIdling& idling) {
     return shallIdleThisFrame;
 }
 
-void parse_uploaded_file(std::string const& filename,
-                         std::string const& mime_type, std::string_view buffer,
+void parse_uploaded_file([[maybe_unused]] std::string const& filename,
+                         [[maybe_unused]] std::string const& mime_type,
+                         std::string_view buffer,
                          void* callback_data = nullptr) {
     if (!buffer.empty()) {
-        fw21::FW21Timeseries decoded =
-            fw21::FW21Timeseries::decode_fw21(buffer);
+        fw21::FW21Timeseries decoded = fw21::decode_station_data(buffer);
 
         if (callback_data != nullptr) {
             auto* met_data_ptr =
@@ -89,24 +95,54 @@ void parse_uploaded_file(std::string const& filename,
     }
 }
 
+// Prompt for the path of a FW21 or mesonet CSV file on the local
+// filesystem. Returns true when the user asks to open it.
+static bool open_file_window(bool& enabled, std::string& path) {
+    static char path_buffer[4096] = "";
+    bool requested = false;
+    ImGui::SetNextWindowSize(ImVec2(500, 0), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("Open File", &enabled)) {
+        ImGui::PushItemWidth(-1);
+        bool entered = ImGui::InputTextWithHint(
+            "##path", "/path/to/station.fw21", path_buffer,
+            sizeof(path_buffer), ImGuiInputTextFlags_EnterReturnsTrue);
+        ImGui::PopItemWidth();
+        if ((ImGui::Button("Open") || entered) &&
+            (std::strlen(path_buffer) > 0)) {
+            path = path_buffer;
+            requested = true;
+            enabled = false;
+        }
+    }
+    ImGui::End();
+    return requested;
+}
+
 void MainApp::RenderLoop() {
     // Main loop
     ImGuiIO& io = ImGui::GetIO();
-    ImGuiStyle& style = ImGui::GetStyle();
     static bool show_imgui_demo = false;
-    static bool show_helpmarkers = false;
+    [[maybe_unused]] static bool show_helpmarkers = false;
     static bool data_are_initialized = false;
 
     std::unique_ptr<fw21::FW21Timeseries> met_data;
+    // Newly loaded data waiting to replace met_data
+    std::unique_ptr<fw21::FW21Timeseries> pending_data;
 
     // Dead Fuel Moisture models
     std::unique_ptr<DeadFuelModelRunner> dfm_1hour;
     std::unique_ptr<DeadFuelModelRunner> dfm_10hour;
     std::unique_ptr<DeadFuelModelRunner> dfm_100hour;
     std::unique_ptr<DeadFuelModelRunner> dfm_1000hour;
+    // Live Fuel Moisture models
+    std::unique_ptr<LiveFuelModelRunner> lfm_herb;
+    std::unique_ptr<LiveFuelModelRunner> lfm_woody;
+    // Fire danger indices
+    std::unique_ptr<NFDRSModelRunner> nfdrs_indices;
 
     ImGuiID dockspace_id, dock_main_id;
 
+    NFDRS_TRACE_THREAD_NAME("ui");
 #ifdef __EMSCRIPTEN__
     io.IniFilename = nullptr;
     EMSCRIPTEN_MAINLOOP_BEGIN
@@ -118,6 +154,7 @@ void MainApp::RenderLoop() {
 #ifndef __EMSCRIPTEN__
         IdleBySleeping(m_fps_idling);
 #endif
+        NFDRS_TRACE_SCOPE("ui", "frame");
 
         // Poll and handle events (inputs, window resize, etc.)
         // You can read the io.WantCaptureMouse, io.WantCaptureKeyboard flags to
@@ -142,6 +179,59 @@ void MainApp::RenderLoop() {
         }
 #endif
 
+#ifndef __EMSCRIPTEN__
+        if (!m_pending_file.empty()) {
+            pending_data = fw21::load_fw21_file(m_pending_file,
+                                                 m_use_decode_cache);
+            m_loaded_file = pending_data ? m_pending_file : std::string();
+            m_pending_file.clear();
+        }
+
+        // Pick up rows appended to a live feed. The columns may
+        // reallocate while growing, so wait until no model is reading
+        // them.
+        static double last_follow_poll = 0.0;
+        auto idle = [](const DeadFuelModelRunner& dfm) {
+            return (!dfm.running()) && (!dfm.ensemble.running());
+        };
+        if ((m_follow_file) && (met_data) && (data_are_initialized) &&
+            (!m_loaded_file.empty()) &&
+            (ClockSeconds() - last_follow_poll > m_follow_interval) &&
+            (idle(*dfm_1hour)) && (idle(*dfm_10hour)) &&
+            (idle(*dfm_100hour)) && (idle(*dfm_1000hour)) &&
+            (!lfm_herb->running()) && (!lfm_woody->running()) &&
+            (!nfdrs_indices->running())) {
+            last_follow_poll = ClockSeconds();
+            fw21::MappedFile mapping(m_loaded_file);
+            const bool replaced = met_data->partial_last_row;
+            // only FW21 feeds can be extended row by row
+            if ((mapping.is_open()) &&
+                (!fw21::is_mesonet_csv(mapping.view())) &&
+                (met_data->append_fw21(mapping.view()) > 0)) {
+                dfm_1hour->extend(*met_data, replaced);
+                dfm_10hour->extend(*met_data, replaced);
+                dfm_100hour->extend(*met_data, replaced);
+                dfm_1000hour->extend(*met_data, replaced);
+                lfm_herb->extend(*met_data, replaced);
+                lfm_woody->extend(*met_data, replaced);
+            }
+        }
+#endif
+
+        // Swap in new data only after the runners reading the old
+        // data have stopped
+        if (pending_data) {
+            nfdrs_indices.reset();
+            dfm_1hour.reset();
+            dfm_10hour.reset();
+            dfm_100hour.reset();
+            dfm_1000hour.reset();
+            lfm_herb.reset();
+            lfm_woody.reset();
+            met_data = std::move(pending_data);
+            data_are_initialized = false;
+        }
+
         if ((met_data) && (!data_are_initialized)) {
             dfm_1hour = std::make_unique<DeadFuelModelRunner>(0.20, "1-hour",
                                                               *met_data);
@@ -151,6 +241,11 @@ void MainApp::RenderLoop() {
                                                                 *met_data);
             dfm_1000hour = std::make_unique<DeadFuelModelRunner>(
                 6.40, "1000-hour", *met_data);
+            lfm_herb = std::make_unique<LiveFuelModelRunner>(
+                LiveFuelType::Herbaceous, "Herbaceous", *met_data);
+            lfm_woody = std::make_unique<LiveFuelModelRunner>(
+                LiveFuelType::Woody, "Woody", *met_data);
+            nfdrs_indices = std::make_unique<NFDRSModelRunner>(*met_data);
 
             data_are_initialized = true;
         }
@@ -159,6 +254,8 @@ void MainApp::RenderLoop() {
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
+        NFDRS_PROFILE_VALUE("scheduler pending tasks",
+                            Scheduler::instance().pending());
         dockspace_id = ImGui::GetID("NFDRSGUI-Dockspace");
 
         ImGui::DockSpaceOverViewport(dockspace_id, m_main_viewport,
@@ -171,10 +268,20 @@ void MainApp::RenderLoop() {
                 /*                &show_helpmarkers);*/
                 ImGui::MenuItem("Idle FPS", nullptr,
                                 &m_fps_idling.idling_enabled);
+                ImGui::MenuItem("Performance", nullptr, &show_performance);
                 ImGui::EndMenu();
             }
 #ifdef __EMSCRIPTEN__
             ImGui::MenuItem("Upload Data", nullptr, &show_upload_window);
+#else
+            if (ImGui::BeginMenu("File")) {
+                ImGui::MenuItem("Open File", nullptr, &show_open_window);
+                ImGui::MenuItem("Follow File", nullptr, &m_follow_file,
+                                !m_loaded_file.empty());
+                ImGui::MenuItem("Cache Decoded Files", nullptr,
+                                &m_use_decode_cache);
+                ImGui::EndMenu();
+            }
 #endif
             if (ImGui::BeginMenu("Configure & Run")) {
                 ImGui::MenuItem("Dead Fuel Moisture Model", nullptr,
@@ -206,7 +313,8 @@ void MainApp::RenderLoop() {
         ImGui::SetNextWindowDockID(dock_main_id, ImGuiCond_Once);
         if (ImGui::Begin("Station Meteogram", nullptr, 0)) {
             meteogram(met_data, *dfm_1hour, *dfm_10hour, *dfm_100hour,
-                      *dfm_1000hour, m_layout_threshold);
+                      *dfm_1000hour, *lfm_herb, *lfm_woody, *nfdrs_indices,
+                      m_layout_threshold);
         }
         ImGui::End();
         /*ImGui::PopStyleVar();*/
@@ -216,16 +324,28 @@ void MainApp::RenderLoop() {
                                *dfm_100hour, *dfm_1000hour, *met_data);
 
         if (show_live_fuel_settings)
-            live_fuel_settings(show_live_fuel_settings);
+            live_fuel_settings(show_live_fuel_settings, *lfm_herb,
+                               *lfm_woody, *met_data);
+
+        if (show_nfdrs_settings)
+            nfdrs_settings(show_nfdrs_settings, *nfdrs_indices, *dfm_1hour,
+                           *dfm_10hour, *dfm_100hour, *dfm_1000hour,
+                           *lfm_herb, *lfm_woody, *met_data);
 
-        if (show_nfdrs_settings) nfdrs_settings(show_nfdrs_settings);
+        if (show_performance) performance_window(show_performance);
 
 #ifdef __EMSCRIPTEN__
         if (show_upload_window) {
-            emscripten_browser_file::upload(".fw21", parse_uploaded_file,
-                                            static_cast<void*>(&met_data));
+            emscripten_browser_file::upload(
+                ".fw21,.csv", parse_uploaded_file,
+                static_cast<void*>(&pending_data));
             show_upload_window = false;
         }
+#else
+        if (show_open_window) {
+            std::string path;
+            if (open_file_window(show_open_window, path)) open_file(path);
+        }
 #endif
 
         // 1. Show the big demo window (Most of the sample code is in
@@ -0,0 +1,93 @@
+#include <NFDRSGUI/Pipeline.h>
+#include <NFDRSGUI/Scheduler.h>
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace nfdrs {
+
+std::size_t Pipeline::add_stage(Stage stage) {
+    auto node = std::make_unique<Node>();
+    node->stage = std::move(stage);
+    m_nodes.push_back(std::move(node));
+    return m_nodes.size() - 1;
+}
+
+void Pipeline::connect(std::size_t from, std::size_t to) {
+    m_nodes[from]->neighbours.push_back(to);
+    m_nodes[to]->neighbours.push_back(from);
+}
+
+std::future<void> Pipeline::start() {
+    std::future<void> finished = m_finished.get_future();
+    m_n_unfinished = m_nodes.size();
+    if (m_nodes.empty()) m_finished.set_value();
+    for (std::size_t node = 0; node < m_nodes.size(); ++node) wake(node);
+    return finished;
+}
+
+void Pipeline::cancel() {
+    m_cancel_requested = true;
+    for (std::size_t node = 0; node < m_nodes.size(); ++node) wake(node);
+}
+
+void Pipeline::wake(std::size_t node) {
+    std::atomic<int>& state = m_nodes[node]->state;
+    int current = state.load(std::memory_order_acquire);
+    for (;;) {
+        if (current == Idle) {
+            if (state.compare_exchange_weak(current, Queued,
+                                            std::memory_order_acq_rel)) {
+                Scheduler::instance().post(
+                    [self = shared_from_this(), node]() { self->run(node); });
+                return;
+            }
+        } else if (current == Running) {
+            // Have the running stage take another turn before sleeping
+            if (state.compare_exchange_weak(current, Notified,
+                                            std::memory_order_acq_rel)) {
+                return;
+            }
+        } else {
+            return;
+        }
+    }
+}
+
+void Pipeline::run(std::size_t node) {
+    Node& self = *m_nodes[node];
+    self.state.store(Running, std::memory_order_release);
+    for (;;) {
+        const Status status = m_cancel_requested.load(std::memory_order_relaxed)
+                                  ? Status::Done
+                                  : self.stage();
+        if (status == Status::Done) {
+            self.state.store(Finished, std::memory_order_release);
+            for (std::size_t neighbour : self.neighbours) wake(neighbour);
+            if (m_n_unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                m_finished.set_value();
+            }
+            return;
+        }
+        if (status == Status::Progress) {
+            for (std::size_t neighbour : self.neighbours) wake(neighbour);
+            // Yield the worker to the other queued stages
+            self.state.store(Queued, std::memory_order_release);
+            Scheduler::instance().post(
+                [pipeline = shared_from_this(), node]() {
+                    pipeline->run(node);
+                });
+            return;
+        }
+        int running = Running;
+        if (self.state.compare_exchange_strong(running, Idle,
+                                               std::memory_order_acq_rel)) {
+            return;
+        }
+        // Woken while running: the blocking condition may be gone
+        self.state.store(Running, std::memory_order_release);
+    }
+}
+
+}  // namespace nfdrs
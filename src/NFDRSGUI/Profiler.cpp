@@ -0,0 +1,268 @@
+#include <NFDRSGUI/Profiler.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nfdrs {
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Metric& Profiler::metric(std::string_view name, bool is_timer) {
+    auto found = m_metrics.find(name);
+    if (found == m_metrics.end()) {
+        found = m_metrics.emplace(std::string(name), Metric()).first;
+        found->second.name = std::string(name);
+        found->second.is_timer = is_timer;
+        found->second.history.reserve(history_size);
+    }
+    return found->second;
+}
+
+void Profiler::add_sample(Metric& metric, double value) {
+    if (metric.history.size() < history_size) {
+        metric.history.push_back(static_cast<float>(value));
+    } else {
+        metric.history[metric.next] = static_cast<float>(value);
+        metric.next = (metric.next + 1) % history_size;
+    }
+    metric.last = value;
+    metric.total += value;
+    ++metric.count;
+}
+
+void Profiler::record_time(std::string_view name, double seconds, double work,
+                           std::string_view work_unit) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Metric& timer = metric(name, true);
+    add_sample(timer, seconds * 1000.0);
+    if (!work_unit.empty()) {
+        timer.work_unit = std::string(work_unit);
+        timer.last_rate = (seconds > 0.0) ? work / seconds : 0.0;
+    }
+}
+
+void Profiler::record_value(std::string_view name, double value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    add_sample(metric(name, false), value);
+}
+
+std::vector<Profiler::Metric> Profiler::metrics() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Metric> copies;
+    copies.reserve(m_metrics.size());
+    for (const auto& entry : m_metrics) copies.push_back(entry.second);
+    return copies;
+}
+
+void Profiler::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_metrics.clear();
+}
+
+// Append text to out as a JSON string
+static void append_json_string(std::string& out, std::string_view text) {
+    out += '"';
+    for (char c : text) {
+        if ((c == '"') || (c == '\\')) {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+static void append_json_number(std::string& out, double value) {
+    char number[32];
+    std::snprintf(number, sizeof(number), "%.6g", value);
+    out += number;
+}
+
+std::string Profiler::to_json() const {
+    const std::vector<Metric> all = metrics();
+    std::string out = "{\n  \"metrics\": [";
+    for (std::size_t idx = 0; idx < all.size(); ++idx) {
+        const Metric& metric = all[idx];
+        out += (idx > 0) ? ",\n    {" : "\n    {";
+        out += "\"name\": ";
+        append_json_string(out, metric.name);
+        // timer samples are in ms
+        out += metric.is_timer ? ", \"kind\": \"timer\", \"unit\": \"ms\""
+                               : ", \"kind\": \"value\"";
+        out += ", \"count\": ";
+        append_json_number(out, static_cast<double>(metric.count));
+        out += ", \"last\": ";
+        append_json_number(out, metric.last);
+        out += ", \"mean\": ";
+        append_json_number(out, metric.mean());
+        if (!metric.work_unit.empty()) {
+            out += ", \"rate\": ";
+            append_json_number(out, metric.last_rate);
+            out += ", \"rate_unit\": ";
+            append_json_string(out, metric.work_unit + "/s");
+        }
+        // oldest first
+        out += ", \"history\": [";
+        for (std::size_t sample = 0; sample < metric.history.size();
+             ++sample) {
+            if (sample > 0) out += ", ";
+            append_json_number(
+                out, metric.history[(metric.next + sample) %
+                                    metric.history.size()]);
+        }
+        out += "]}";
+    }
+    out += "\n  ]\n}\n";
+    return out;
+}
+
+bool Profiler::write_json(const std::string& path) const {
+    std::ofstream file(path);
+    if (file) file << to_json();
+    if (!file) {
+        std::cerr << "Could not write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+Tracer& Tracer::instance() {
+    static Tracer tracer;
+    return tracer;
+}
+
+void Tracer::set_capacity(std::size_t events_per_thread) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_capacity = std::max<std::size_t>(events_per_thread, 1);
+}
+
+Tracer::ThreadBuffer& Tracer::thread_buffer() {
+    static thread_local std::shared_ptr<ThreadBuffer> t_buffer;
+    if (!t_buffer) {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        buffer->capacity = m_capacity;
+        buffer->tid = static_cast<int>(m_buffers.size());
+        m_buffers.push_back(buffer);
+        t_buffer = std::move(buffer);
+    }
+    return *t_buffer;
+}
+
+void Tracer::set_thread_name(std::string_view name) {
+    ThreadBuffer& buffer = thread_buffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.name = std::string(name);
+}
+
+void Tracer::record(const char* category, const char* name,
+                    const char* detail, std::int64_t start_ns,
+                    std::int64_t end_ns) {
+    Event event{category, name, start_ns, end_ns, {}};
+    if (detail != nullptr) {
+        std::strncpy(event.detail, detail, sizeof(event.detail) - 1);
+    }
+
+    // Only the exporting thread ever waits on this lock
+    ThreadBuffer& buffer = thread_buffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.events.size() < buffer.capacity) {
+        // the ring is allocated once, on the first event
+        if (buffer.events.empty()) buffer.events.reserve(buffer.capacity);
+        buffer.events.push_back(event);
+    } else {
+        buffer.events[buffer.next] = event;
+        buffer.next = (buffer.next + 1) % buffer.capacity;
+    }
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& buffer : m_buffers) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        buffer->events.clear();
+        buffer->next = 0;
+    }
+}
+
+// Nanoseconds as the microseconds of the trace format
+static void append_json_us(std::string& out, std::int64_t ns) {
+    char number[32];
+    std::snprintf(number, sizeof(number), "%.3f", ns * 1e-3);
+    out += number;
+}
+
+std::string Tracer::to_json() const {
+    std::string out = "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+    auto begin_event = [&out, &first]() {
+        out += first ? "\n  {" : ",\n  {";
+        first = false;
+    };
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& buffer : m_buffers) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        const std::string tid = std::to_string(buffer->tid);
+        if (!buffer->name.empty()) {
+            begin_event();
+            out += "\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, ";
+            out += "\"tid\": " + tid + ", \"args\": {\"name\": ";
+            append_json_string(out, buffer->name);
+            out += "}}";
+        }
+        // oldest first
+        const std::size_t n_events = buffer->events.size();
+        for (std::size_t idx = 0; idx < n_events; ++idx) {
+            const Event& event =
+                buffer->events[(buffer->next + idx) % n_events];
+            begin_event();
+            out += "\"name\": ";
+            append_json_string(out, event.name);
+            out += ", \"cat\": ";
+            append_json_string(out, event.category);
+            out += ", \"ph\": \"X\", \"pid\": 1, \"tid\": " + tid;
+            out += ", \"ts\": ";
+            append_json_us(out, event.start_ns);
+            out += ", \"dur\": ";
+            append_json_us(out, event.end_ns - event.start_ns);
+            if (event.detail[0] != '\0') {
+                out += ", \"args\": {\"detail\": ";
+                append_json_string(out, event.detail);
+                out += "}";
+            }
+            out += "}";
+        }
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+bool Tracer::write_json(const std::string& path) const {
+    std::ofstream file(path);
+    if (file) file << to_json();
+    if (!file) {
+        std::cerr << "Could not write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace nfdrs
@@ -0,0 +1,233 @@
+#include <NFDRSGUI/ResultCache.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace nfdrs {
+
+// Spill file layout (native byte order): SpillHeader, then n_rows
+// radial moisture values and n_rows fuel temperature values
+static constexpr char spill_magic[8] = {'N', 'F', 'D', 'R', 'S', 'D', 'F', 'M'};
+static constexpr std::uint32_t spill_version = 1;
+static constexpr std::uint32_t byte_order_mark = 0x01020304;
+
+struct SpillHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order_mark;
+    std::uint64_t key;
+    std::int64_t n_rows;
+};
+
+// DeadFuelMoisture keeps its per-node state (radii, moisture,
+// temperature, saturation, diffusivities and the like) in heap arrays
+// of stick_nodes doubles, which sizeof doesn't see. This is an upper
+// bound on how many it has.
+static constexpr std::size_t dead_fuel_node_arrays = 12;
+
+std::size_t DeadFuelResult::memory_usage() const {
+    std::size_t model_bytes = 0;
+    if (final_state) {
+        model_bytes = sizeof(DeadFuelMoisture) +
+                      dead_fuel_node_arrays *
+                          static_cast<std::size_t>(std::max(stick_nodes, 0)) *
+                          sizeof(double);
+    }
+    return sizeof(*this) +
+           (radial_moisture.capacity() + fuel_temperature.capacity()) *
+               sizeof(double) +
+           model_bytes;
+}
+
+ResultCache::ResultCache(std::size_t budget, std::string spill_directory)
+    : m_budget(budget) {
+    set_spill_directory(std::move(spill_directory));
+}
+
+ResultCache& ResultCache::instance() {
+    static ResultCache cache;
+    return cache;
+}
+
+void ResultCache::set_spill_directory(std::string spill_directory) {
+    if (!spill_directory.empty()) {
+        std::error_code err;
+        std::filesystem::create_directories(spill_directory, err);
+        if (err) {
+            std::cerr << "Unable to create result cache directory "
+                      << spill_directory << std::endl;
+            spill_directory.clear();
+        }
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_spill_directory = std::move(spill_directory);
+}
+
+void ResultCache::set_budget(std::size_t budget) {
+    std::vector<Entry> evicted;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_budget = budget;
+        evicted = evict();
+    }
+    for (const Entry& entry : evicted) spill(entry);
+}
+
+std::size_t ResultCache::memory_usage() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_usage;
+}
+
+std::vector<ResultCache::Entry> ResultCache::evict() {
+    std::vector<Entry> evicted;
+    while ((m_usage > m_budget) && (!m_entries.empty())) {
+        Entry& oldest = m_entries.back();
+        m_usage -= oldest.result->memory_usage();
+        m_index.erase(oldest.key);
+        evicted.push_back(std::move(oldest));
+        m_entries.pop_back();
+    }
+    return evicted;
+}
+
+std::string ResultCache::spill_path(std::uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.dfm",
+                  static_cast<unsigned long long>(key));
+    return (std::filesystem::path(m_spill_directory) / name).string();
+}
+
+bool ResultCache::spill(const Entry& entry) const {
+    if (entry.on_disk) return true;
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_spill_directory.empty()) return false;
+        path = spill_path(entry.key);
+    }
+    const DeadFuelResult& result = *entry.result;
+    SpillHeader header = {};
+    std::memcpy(header.magic, spill_magic, sizeof(spill_magic));
+    header.version = spill_version;
+    header.byte_order_mark = byte_order_mark;
+    header.key = entry.key;
+    header.n_rows = static_cast<std::int64_t>(result.radial_moisture.size());
+
+    // written under a temporary name and renamed into place, so readers
+    // never see a partial file
+    const std::string tmp_path = path + ".tmp";
+    std::ofstream outfile(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!outfile) return false;
+    const std::size_t n_bytes = result.radial_moisture.size() * sizeof(double);
+    outfile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    outfile.write(reinterpret_cast<const char*>(result.radial_moisture.data()),
+                  n_bytes);
+    outfile.write(
+        reinterpret_cast<const char*>(result.fuel_temperature.data()),
+        n_bytes);
+    outfile.close();
+
+    std::error_code err;
+    if (!outfile) {
+        std::filesystem::remove(tmp_path, err);
+        return false;
+    }
+    std::filesystem::rename(tmp_path, path, err);
+    if (err) {
+        std::cerr << "Unable to write result cache " << path << std::endl;
+        std::filesystem::remove(tmp_path, err);
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<const DeadFuelResult> ResultCache::unspill(
+    std::uint64_t key) const {
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_spill_directory.empty()) return nullptr;
+        path = spill_path(key);
+    }
+    std::ifstream infile(path, std::ios::binary);
+    if (!infile) return nullptr;
+
+    SpillHeader header;
+    infile.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if ((!infile) ||
+        (std::memcmp(header.magic, spill_magic, sizeof(spill_magic)) != 0) ||
+        (header.version != spill_version) ||
+        (header.byte_order_mark != byte_order_mark) || (header.key != key) ||
+        (header.n_rows < 0)) {
+        return nullptr;
+    }
+
+    auto result = std::make_shared<DeadFuelResult>();
+    const std::size_t n_rows = static_cast<std::size_t>(header.n_rows);
+    result->radial_moisture.resize(n_rows);
+    result->fuel_temperature.resize(n_rows);
+    infile.read(reinterpret_cast<char*>(result->radial_moisture.data()),
+                n_rows * sizeof(double));
+    infile.read(reinterpret_cast<char*>(result->fuel_temperature.data()),
+                n_rows * sizeof(double));
+    if (!infile) return nullptr;
+    return result;
+}
+
+std::shared_ptr<const DeadFuelResult> ResultCache::find(std::uint64_t key) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto found = m_index.find(key);
+        if (found != m_index.end()) {
+            // move to the front as the most recently used
+            m_entries.splice(m_entries.begin(), m_entries, found->second);
+            return found->second->result;
+        }
+    }
+    std::shared_ptr<const DeadFuelResult> result = unspill(key);
+    if (result) insert(key, result, true);
+    return result;
+}
+
+void ResultCache::insert(std::uint64_t key,
+                         std::shared_ptr<const DeadFuelResult> result,
+                         bool on_disk) {
+    if (!result) return;
+    std::vector<Entry> evicted;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto found = m_index.find(key);
+        if (found != m_index.end()) {
+            m_usage -= found->second->result->memory_usage();
+            m_entries.erase(found->second);
+            m_index.erase(found);
+        }
+        m_usage += result->memory_usage();
+        m_entries.push_front({key, std::move(result), on_disk});
+        m_index[key] = m_entries.begin();
+        evicted = evict();
+    }
+    // disk writes happen outside the lock
+    for (const Entry& entry : evicted) spill(entry);
+}
+
+void ResultCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_index.clear();
+    m_usage = 0;
+}
+
+}  // namespace nfdrs
@@ -0,0 +1,167 @@
+#include <NFDRSGUI/Profiler.h>
+#include <NFDRSGUI/Scheduler.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace nfdrs {
+
+// The pool and queue the current thread works for, if any
+static thread_local const Scheduler* t_scheduler = nullptr;
+static thread_local std::size_t t_queue = 0;
+
+Scheduler::Scheduler(unsigned n_threads) {
+    if (n_threads == 0) n_threads = std::thread::hardware_concurrency();
+#ifdef __EMSCRIPTEN__
+    // stay within the preallocated worker pool (PTHREAD_POOL_SIZE)
+    n_threads = std::min(n_threads, 4u);
+#endif
+    n_threads = std::max(n_threads, 1u);
+
+    for (unsigned thread = 0; thread < n_threads; ++thread) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (unsigned thread = 0; thread < n_threads; ++thread) {
+        m_threads.emplace_back(&Scheduler::worker_loop, this, thread);
+    }
+}
+
+Scheduler::~Scheduler() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& thread : m_threads) thread.join();
+}
+
+Scheduler& Scheduler::instance(unsigned n_threads) {
+    static Scheduler scheduler(n_threads);
+    return scheduler;
+}
+
+void Scheduler::push(std::function<void()> task) {
+    // Workers keep their own tasks local; everybody else spreads theirs
+    // over the queues
+    const std::size_t queue = (t_scheduler == this)
+                                  ? t_queue
+                                  : m_next_queue++ % m_queues.size();
+    // counted first so a fast thief can never take the count below 0
+    m_pending++;
+    {
+        std::lock_guard<std::mutex> lock(m_queues[queue]->mutex);
+        m_queues[queue]->tasks.push_back(std::move(task));
+    }
+    // taking the lock orders this wake-up after a sleeper's check
+    { std::lock_guard<std::mutex> lock(m_sleep_mutex); }
+    m_wake.notify_one();
+}
+
+bool Scheduler::try_pop(std::size_t queue, std::function<void()>& task) {
+    // newest task of our own queue first, as its data is likely cached
+    {
+        WorkerQueue& own = *m_queues[queue];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            m_pending--;
+            return true;
+        }
+    }
+    // otherwise steal the oldest task of another queue
+    for (std::size_t offset = 1; offset < m_queues.size(); ++offset) {
+        WorkerQueue& other = *m_queues[(queue + offset) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            m_pending--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Scheduler::worker_loop(std::size_t queue) {
+    t_scheduler = this;
+    t_queue = queue;
+    NFDRS_TRACE_THREAD_NAME("worker " + std::to_string(queue));
+    std::function<void()> task;
+    while (true) {
+        if (try_pop(queue, task)) {
+            {
+                NFDRS_TRACE_SCOPE("scheduler", "task");
+                task();
+            }
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        m_wake.wait(lock, [this]() { return m_stopping || (m_pending > 0); });
+        // drain what is left before shutting down
+        if (m_stopping && (m_pending == 0)) return;
+    }
+}
+
+void Scheduler::parallel_for(std::size_t n,
+                             const std::function<void(std::size_t)>& body,
+                             unsigned max_threads) {
+    if (n == 0) return;
+    if ((n == 1) || (max_threads == 1)) {
+        for (std::size_t idx = 0; idx < n; ++idx) body(idx);
+        return;
+    }
+
+    // Shared with the helper tasks, which may only start after this call
+    // has returned; they then find no work left and never touch body.
+    struct Loop {
+        const std::function<void(std::size_t)>* body;
+        std::size_t n;
+        std::atomic<std::size_t> next = 0;
+        std::atomic<std::size_t> done = 0;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto loop = std::make_shared<Loop>();
+    loop->body = &body;
+    loop->n = n;
+    auto work = [](Loop& state) {
+        for (std::size_t idx = state.next++; idx < state.n;
+             idx = state.next++) {
+            (*state.body)(idx);
+            if (++state.done == state.n) {
+                // taking the lock orders this after the caller's check
+                { std::lock_guard<std::mutex> lock(state.mutex); }
+                state.finished.notify_all();
+            }
+        }
+    };
+
+    std::size_t n_helpers = std::min<std::size_t>(n - 1, size());
+    if (max_threads > 0) {
+        n_helpers = std::min<std::size_t>(n_helpers, max_threads - 1);
+    }
+    for (std::size_t helper = 0; helper < n_helpers; ++helper) {
+        push([loop, work]() { work(*loop); });
+    }
+    work(*loop);
+
+    // Every iteration has been claimed. Sleep until the ones still
+    // running on other threads are done, rather than picking up
+    // unrelated queued work such as a whole model run. Those iterations
+    // only ever wait on loops nested inside them, which their own thread
+    // can always finish, so this can't deadlock.
+    std::unique_lock<std::mutex> lock(loop->mutex);
+    loop->finished.wait(lock, [&loop, n]() { return loop->done == n; });
+}
+
+}  // namespace nfdrs
@@ -0,0 +1,192 @@
+#include <NFDRSGUI/FW21Decoder.h>
+#include <NFDRSGUI/FileLoader.h>
+#include <NFDRSGUI/Scheduler.h>
+#include <NFDRSGUI/StationStore.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace fw21 {
+
+// Drop the rows of ts_data whose timestamp failed to decode (-1, or NaN
+// from a mesonet file), so they can't be sorted and merged into a
+// bogus row. Returns the number of rows dropped.
+static std::ptrdiff_t drop_invalid_times(FW21Timeseries& ts_data) {
+    const Column<double>& time = ts_data.date_time;
+    auto invalid = [](double unix_time) {
+        return (unix_time == -1.0) || std::isnan(unix_time);
+    };
+    const std::ptrdiff_t n_invalid =
+        std::count_if(time.begin(), time.end(), invalid);
+    if (n_invalid == 0) return 0;
+
+    FW21Timeseries valid(ts_data.NT - n_invalid, ts_data.met_precision());
+    for (std::ptrdiff_t row = 0; row < ts_data.NT; ++row) {
+        if (!invalid(time[row])) valid.push_row(ts_data.row(row));
+    }
+    valid.station_id = std::move(ts_data.station_id);
+    valid.consumed_bytes = ts_data.consumed_bytes;
+    valid.header_consumed = ts_data.header_consumed;
+    // append_fw21 replaces a partial last row, which must still be there
+    valid.partial_last_row =
+        ts_data.partial_last_row && (!invalid(time[ts_data.NT - 1]));
+    ts_data = std::move(valid);
+    return n_invalid;
+}
+
+// Sort the rows of ts_data by time and drop repeated timestamps,
+// keeping the first occurrence. Already ordered series are untouched.
+static void sort_by_time(FW21Timeseries& ts_data) {
+    const Column<double>& time = ts_data.date_time;
+    if (std::adjacent_find(time.begin(), time.end(),
+                           [](double lhs, double rhs) {
+                               return lhs >= rhs;
+                           }) == time.end()) {
+        return;
+    }
+
+    std::vector<std::ptrdiff_t> rows(time.size());
+    std::iota(rows.begin(), rows.end(), 0);
+    std::stable_sort(rows.begin(), rows.end(),
+                     [&time](std::ptrdiff_t lhs, std::ptrdiff_t rhs) {
+                         return time[lhs] < time[rhs];
+                     });
+    rows.erase(std::unique(rows.begin(), rows.end(),
+                           [&time](std::ptrdiff_t lhs, std::ptrdiff_t rhs) {
+                               return time[lhs] == time[rhs];
+                           }),
+               rows.end());
+
+    FW21Timeseries sorted(static_cast<std::ptrdiff_t>(rows.size()),
+                          ts_data.met_precision());
+    for (std::ptrdiff_t row : rows) sorted.push_row(ts_data.row(row));
+    sorted.station_id = std::move(ts_data.station_id);
+    sorted.consumed_bytes = ts_data.consumed_bytes;
+    sorted.header_consumed = ts_data.header_consumed;
+    sorted.partial_last_row = ts_data.partial_last_row;
+    ts_data = std::move(sorted);
+}
+
+std::size_t StationStore::load_directory(const std::string& directory,
+                                         unsigned n_threads,
+                                         Precision met_precision,
+                                         bool use_cache) {
+    std::vector<std::string> paths;
+    std::error_code err;
+    for (const auto& entry :
+         std::filesystem::directory_iterator(directory, err)) {
+        if ((entry.is_regular_file(err)) &&
+            (entry.path().extension() == ".fw21")) {
+            paths.push_back(entry.path().string());
+        }
+    }
+    if (err) {
+        std::cerr << "Unable to read directory " << directory << std::endl;
+    }
+    // merge multiple files of one station in a predictable order
+    std::sort(paths.begin(), paths.end());
+
+    // Each task decodes a whole file serially; parallelism comes from
+    // working on many files at once
+    std::vector<std::unique_ptr<FW21Timeseries>> decoded(paths.size());
+    nfdrs::Scheduler::instance().parallel_for(
+        paths.size(),
+        [&](std::size_t idx) {
+            decoded[idx] =
+                load_fw21_file(paths[idx], use_cache, 1, met_precision);
+        },
+        n_threads);
+
+    std::size_t n_loaded = 0;
+    for (std::size_t idx = 0; idx < decoded.size(); ++idx) {
+        if ((decoded[idx]) && (insert(std::move(decoded[idx]), paths[idx]))) {
+            ++n_loaded;
+        }
+    }
+    return n_loaded;
+}
+
+bool StationStore::insert(std::unique_ptr<FW21Timeseries> series,
+                          const std::string& source_path) {
+    const std::string& source =
+        source_path.empty() ? std::string("input") : source_path;
+    // Files without a station ID are kept apart under their path rather
+    // than merged with each other
+    std::string key = series->station_id;
+    if (key.empty()) {
+        if (source_path.empty()) {
+            std::cerr << "Skipping " << source
+                      << ": it has no station ID to file it under."
+                      << std::endl;
+            return false;
+        }
+        key = source_path;
+    }
+
+    const std::ptrdiff_t n_invalid = drop_invalid_times(*series);
+    if (n_invalid > 0) {
+        std::cerr << "Dropped " << n_invalid << " rows of " << source
+                  << " with an invalid timestamp." << std::endl;
+    }
+    if (series->NT == 0) {
+        std::cerr << "Skipping " << source << ": it has no valid rows."
+                  << std::endl;
+        return false;
+    }
+
+    auto found = m_stations.find(key);
+    if (found == m_stations.end()) {
+        sort_by_time(*series);
+        series->calc_fire_cat();
+        m_stations.emplace(std::move(key), std::move(series));
+        return true;
+    }
+
+    FW21Timeseries& merged = *found->second;
+    merged.append(*series);
+    // the merged series no longer corresponds to a single source file
+    merged.consumed_bytes = 0;
+    merged.header_consumed = false;
+    merged.partial_last_row = false;
+    sort_by_time(merged);
+    merged.calc_fire_cat();
+    return true;
+}
+
+const FW21Timeseries* StationStore::find(
+    const std::string& station_id) const {
+    auto found = m_stations.find(station_id);
+    return (found != m_stations.end()) ? found->second.get() : nullptr;
+}
+
+TimeSlice StationStore::slice(const std::string& station_id, double t0,
+                              double t1) const {
+    TimeSlice result;
+    result.series = find(station_id);
+    if (result.series == nullptr) return result;
+
+    const Column<double>& time = result.series->date_time;
+    result.begin = std::lower_bound(time.begin(), time.end(), t0) -
+                   time.begin();
+    result.end = std::upper_bound(time.begin(), time.end(), t1) -
+                 time.begin();
+    result.end = std::max(result.begin, result.end);
+    return result;
+}
+
+std::vector<std::string> StationStore::station_ids() const {
+    std::vector<std::string> ids;
+    ids.reserve(m_stations.size());
+    for (const auto& [id, series] : m_stations) ids.push_back(id);
+    return ids;
+}
+
+}  // namespace fw21
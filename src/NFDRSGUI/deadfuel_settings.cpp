@@ -3,10 +3,33 @@
 
 #include "NFDRSGUI/FW21Decoder.h"
 #include "NFDRSGUI/ModelRunners.h"
+#include <algorithm>
+
 #include "imgui.h"
 
 namespace nfdrs {
 
+// Sample n_members settings around those of dfm, with the adsorption
+// and desorption rates varied by up to spread (a fraction) either way,
+// and run them as dfm's ensemble
+static void run_ensemble(DeadFuelModelRunner& dfm,
+                         const fw21::FW21Timeseries& data, int n_members,
+                         double spread) {
+    constexpr int n_rate_steps = 5;
+    DeadFuelSweep sweep;
+    for (int step = 0; step < n_rate_steps; ++step) {
+        const double scale =
+            1.0 + spread * (2.0 * step / (n_rate_steps - 1) - 1.0);
+        sweep.adsorption_rates.push_back(dfm.settings.adsorption_rate * scale);
+        sweep.desorption_rates.push_back(dfm.settings.desorption_rate * scale);
+    }
+    for (int seed = 0; seed < n_members; ++seed) {
+        sweep.random_seeds.push_back(seed);
+    }
+    dfm.ensemble.run(sweep.sample(dfm.settings, n_members, 0), dfm.radius,
+                     dfm.name, data);
+}
+
 static void individual_settings(const char* title, DeadFuelModelRunner& dfm,
                                 fw21::FW21Timeseries& data) {
     if (ImGui::BeginTabItem(title)) {
@@ -30,13 +53,23 @@ static void individual_settings(const char* title, DeadFuelModelRunner& dfm,
         }
         ImGui::SameLine();
         if (ImGui::Button("Run")) {
-            if (dfm.model->updates() > 0) {
-                dfm.reset();
-            }
-            dfm.run(data);
+            dfm.restart(data);
+        }
+        ImGui::SameLine();
+        ImGui::ProgressBar(dfm.progress());
+
+        ImGui::SeparatorText("Ensemble");
+        DeadFuelEnsemble& ensemble = dfm.ensemble;
+        ImGui::InputInt("Members", &ensemble.n_members);
+        ensemble.n_members = std::max(ensemble.n_members, 1);
+        ImGui::SliderFloat("Rate Spread (%)", &ensemble.rate_spread, 0.0f,
+                           100.0f, "%.0f");
+        if (ImGui::Button("Run Ensemble")) {
+            run_ensemble(dfm, data, ensemble.n_members,
+                         ensemble.rate_spread / 100.0);
         }
         ImGui::SameLine();
-        ImGui::ProgressBar(dfm.progress);
+        ImGui::ProgressBar(dfm.ensemble.progress());
         ImGui::PopItemWidth();
         ImGui::EndTabItem();
     }
@@ -1,29 +1,49 @@
 
 #include <NFDRSGUI/NFDRSGUI.h>
 
-/*#include "NFDRSGUI/ModelRunners.h"*/
+#include "NFDRSGUI/FW21Decoder.h"
+#include "NFDRSGUI/ModelRunners.h"
+#include <algorithm>
+
 #include "imgui.h"
 
 namespace nfdrs {
 
-static void individual_settings(const char* title) {
+static void individual_settings(const char* title, LiveFuelModelRunner& lfm,
+                                fw21::FW21Timeseries& data) {
     if (ImGui::BeginTabItem(title)) {
+        ImGui::PushItemWidth(ImGui::GetFontSize() * -15);
+        ImGui::InputDouble("Latitude", &lfm.settings.latitude);
+        lfm.settings.latitude = std::clamp(lfm.settings.latitude, -90.0, 90.0);
+        ImGui::InputInt("Averaging Days", &lfm.settings.averaging_days);
+        lfm.settings.averaging_days = std::max(lfm.settings.averaging_days, 1);
+        ImGui::InputDouble("Greenup Threshold",
+                           &lfm.settings.greenup_threshold);
+        lfm.settings.greenup_threshold =
+            std::clamp(lfm.settings.greenup_threshold, 0.0, 0.99);
+        ImGui::InputDouble("Minimum Moisture", &lfm.settings.min_moisture);
+        ImGui::InputDouble("Maximum Moisture", &lfm.settings.max_moisture);
         if (ImGui::Button("Default")) {
+            lfm.default_settings();
         }
         ImGui::SameLine();
         if (ImGui::Button("Run")) {
+            lfm.restart(data);
         }
         ImGui::SameLine();
-        ImGui::ProgressBar(0);
+        ImGui::ProgressBar(lfm.progress());
+        ImGui::PopItemWidth();
         ImGui::EndTabItem();
     }
 }
 
-void live_fuel_settings(bool& enabled) {
+void live_fuel_settings(bool& enabled, LiveFuelModelRunner& lfm_herb,
+                        LiveFuelModelRunner& lfm_woody,
+                        fw21::FW21Timeseries& data) {
     if (ImGui::Begin("Live Fuel Model Settings", &enabled)) {
         if (ImGui::BeginTabBar("Live Fuel Models")) {
-            individual_settings("Herbaceous Fuels");
-            individual_settings("Woody Fuels");
+            individual_settings("Herbaceous Fuels", lfm_herb, data);
+            individual_settings("Woody Fuels", lfm_woody, data);
         }
         ImGui::EndTabBar();
     }
@@ -1,8 +1,16 @@
 #include <NFDRSGUI/NFDRSGUI.h>
 
-int main() {
+int main(int argc, char** argv) {
     nfdrs::MainApp nfdrs_ui;
 
+#ifndef __EMSCRIPTEN__
+    // optionally open a FW21 file given on the command line
+    if (argc > 1) nfdrs_ui.open_file(argv[1]);
+#else
+    (void)argc;
+    (void)argv;
+#endif
+
     nfdrs_ui.RenderLoop();
 
     return 0;
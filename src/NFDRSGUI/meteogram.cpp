@@ -1,89 +1,158 @@
 #include <NFDRSGUI/FW21Decoder.h>
 /*#include <NFDRSGUI/ModelRunners.h>*/
 #include <NFDRSGUI/NFDRSGUI.h>
+#include <NFDRSGUI/Profiler.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstddef>
 #include <ctime>
 #include <memory>
+#include <vector>
 
 #include "imgui.h"
 #include "implot.h"
 
 namespace nfdrs {
 
+// Shade the fire weather category spans between bounds.x and bounds.y.
+// Only the spans overlapping the visible time range are drawn.
 static void PlotFireWxCat(const char* label_id, const double* xs,
-                          const int* categories, int count, const ImVec2 bounds,
+                          const std::vector<fw21::FireCatSpan>& spans,
+                          std::ptrdiff_t count, const ImVec2 bounds,
                           const ImVec4 elev_col, const ImVec4 crit_col,
                           const ImVec4 extr_col) {
-    ImDrawList* draw_list = ImPlot::GetPlotDrawList();
-
     if (ImPlot::BeginItem(label_id)) {
-        int prev_fire_cat = 0;
-        ImVec2 start_pos;
-        ImVec2 end_pos;
-        int start_idx, end_idx;
         ImPlot::GetCurrentItem()->Color = IM_COL32(64, 64, 64, 255);
-        for (int idx = 0; idx < count; ++idx) {
-            const int fire_cat = categories[idx];
-
-            if ((fire_cat > 0) && (prev_fire_cat == 0)) {
-                start_idx = idx;
-                start_pos = ImPlot::PlotToPixels(xs[idx], bounds.x);
-            } else if ((fire_cat > 0) && (prev_fire_cat != 0) &&
-                       (prev_fire_cat != fire_cat)) {
-                end_idx = idx;
-                end_pos = ImPlot::PlotToPixels(xs[idx], bounds.y);
-
-                // What was the max category?
-                int max_cat = 0;
-                for (int i = start_idx; i < end_idx; ++i) {
-                    if (categories[i] > max_cat) max_cat = prev_fire_cat;
-                }
-
-                ImU32 col;
-                if (max_cat == 1) {
-                    col = ImGui::GetColorU32(elev_col);
-                } else if (max_cat == 2) {
-                    col = ImGui::GetColorU32(crit_col);
-                } else if (max_cat == 3) {
-                    col = ImGui::GetColorU32(extr_col);
-                }
-
-                draw_list->AddRectFilled(start_pos, end_pos, col);
-                start_pos = ImPlot::PlotToPixels(xs[idx], bounds.x);
-                start_idx = idx;
-
-            } else if ((fire_cat == 0) && (prev_fire_cat != 0)) {
-                end_pos = ImPlot::PlotToPixels(xs[idx], bounds.y);
-                end_idx = idx;
-
-                // What was the max category?
-                int max_cat = 0;
-                for (int i = start_idx; i < end_idx; ++i) {
-                    if (categories[i] > max_cat) max_cat = prev_fire_cat;
-                }
-
-                ImU32 col;
-                if (max_cat == 1) {
-                    col = ImGui::GetColorU32(elev_col);
-                } else if (max_cat == 2) {
-                    col = ImGui::GetColorU32(crit_col);
-                } else if (max_cat == 3) {
-                    col = ImGui::GetColorU32(extr_col);
-                }
-
-                draw_list->AddRectFilled(start_pos, end_pos, col);
-            }
-            prev_fire_cat = fire_cat;
+        ImDrawList* draw_list = ImPlot::GetPlotDrawList();
+        const ImU32 colors[] = {ImGui::GetColorU32(elev_col),
+                                ImGui::GetColorU32(crit_col),
+                                ImGui::GetColorU32(extr_col)};
+        // a span running to the last row ends at the last timestamp
+        auto span_end = [xs, count](const fw21::FireCatSpan& span) {
+            return xs[std::min(span.end, count - 1)];
+        };
+
+        const ImPlotRect limits = ImPlot::GetPlotLimits();
+        auto span = std::partition_point(
+            spans.begin(), spans.end(),
+            [&](const fw21::FireCatSpan& candidate) {
+                return span_end(candidate) < limits.X.Min;
+            });
+        for (; (span != spans.end()) && (xs[span->start] <= limits.X.Max);
+             ++span) {
+            const ImVec2 start_pos =
+                ImPlot::PlotToPixels(xs[span->start], bounds.x);
+            const ImVec2 end_pos = ImPlot::PlotToPixels(span_end(*span),
+                                                        bounds.y);
+            draw_list->AddRectFilled(start_pos, end_pos,
+                                     colors[span->category - 1]);
         }
         ImPlot::EndItem();
     }
 }
 
-static void temperature_and_humidity(const double stime[], const double tmpc[],
-                                     const double relh[],
-                                     const int firewx_cat[], std::ptrdiff_t N) {
+// Getter state for plotting a meteorological column that isn't stored
+// as doubles. ref is the fill baseline of PlotMetShaded.
+struct MetPlotData {
+    const double* stime;
+    const fw21::MetColumn* column;
+    double ref;
+};
+
+static ImPlotPoint met_getter(int idx, void* data) {
+    const auto* met = static_cast<const MetPlotData*>(data);
+    return ImPlotPoint(met->stime[idx], (*met->column)[idx]);
+}
+
+static ImPlotPoint ref_getter(int idx, void* data) {
+    const auto* met = static_cast<const MetPlotData*>(data);
+    return ImPlotPoint(met->stime[idx], met->ref);
+}
+
+// The PlotMet* functions plot straight from the column when it holds
+// doubles and decode through a getter otherwise
+static void PlotMetLine(const char* label_id, const double* stime,
+                        const fw21::MetColumn& column, std::ptrdiff_t N) {
+    if (column.data()) {
+        ImPlot::PlotLine(label_id, stime, column.data(), N);
+        return;
+    }
+    MetPlotData met = {stime, &column, 0};
+    ImPlot::PlotLineG(label_id, met_getter, &met, N);
+}
+
+static void PlotMetScatter(const char* label_id, const double* stime,
+                           const fw21::MetColumn& column, std::ptrdiff_t N) {
+    if (column.data()) {
+        ImPlot::PlotScatter(label_id, stime, column.data(), N);
+        return;
+    }
+    MetPlotData met = {stime, &column, 0};
+    ImPlot::PlotScatterG(label_id, met_getter, &met, N);
+}
+
+static void PlotMetBars(const char* label_id, const double* stime,
+                        const fw21::MetColumn& column, std::ptrdiff_t N,
+                        double bar_size) {
+    if (column.data()) {
+        ImPlot::PlotBars(label_id, stime, column.data(), N, bar_size);
+        return;
+    }
+    MetPlotData met = {stime, &column, 0};
+    ImPlot::PlotBarsG(label_id, met_getter, &met, N, bar_size);
+}
+
+// Shade between upper and lower, or down to the bottom of the plot when
+// lower is nullptr
+static void PlotMetShaded(const char* label_id, const double* stime,
+                          const fw21::MetColumn& upper,
+                          const fw21::MetColumn* lower, std::ptrdiff_t N) {
+    if (upper.data() && lower && lower->data()) {
+        ImPlot::PlotShaded(label_id, stime, upper.data(), lower->data(), N);
+        return;
+    }
+    if (upper.data() && !lower) {
+        ImPlot::PlotShaded(label_id, stime, upper.data(), N, -INFINITY);
+        return;
+    }
+    MetPlotData upper_met = {stime, &upper, 0};
+    MetPlotData lower_met = {stime, lower ? lower : &upper,
+                             ImPlot::GetPlotLimits().Y.Min};
+    ImPlot::PlotShadedG(label_id, met_getter, &upper_met,
+                        lower ? met_getter : ref_getter, &lower_met, N);
+}
+
+// Shade the moisture envelope of an ensemble: min to max faintly, the
+// 10th to 90th percentiles more strongly, and the median as a line.
+// Only the rows computed so far are drawn.
+static void PlotEnvelope(const char* label_id, const double* stime,
+                         const DeadFuelEnsemble& ensemble,
+                         const ImVec4 color) {
+    const int count = static_cast<int>(
+        ensemble.n_done.load(std::memory_order_acquire));
+    if (count == 0) return;
+    const DeadFuelEnvelope& envelope = ensemble.moisture;
+    ImPlot::PushStyleColor(ImPlotCol_Fill, color);
+    ImPlot::PushStyleColor(ImPlotCol_Line, color);
+    ImPlot::PushStyleVar(ImPlotStyleVar_FillAlpha, 0.15f);
+    ImPlot::PlotShaded(label_id, stime, envelope.min.data(),
+                       envelope.max.data(), count);
+    ImPlot::PopStyleVar();
+    ImPlot::PushStyleVar(ImPlotStyleVar_FillAlpha, 0.35f);
+    ImPlot::PlotShaded(label_id, stime, envelope.p10.data(),
+                       envelope.p90.data(), count);
+    ImPlot::PopStyleVar();
+    ImPlot::PlotLine(label_id, stime, envelope.median.data(), count);
+    ImPlot::PopStyleColor(2);
+}
+
+static void temperature_and_humidity(
+    const double stime[], const fw21::MetColumn& tmpc,
+    const fw21::MetColumn& relh,
+    const std::vector<fw21::FireCatSpan>& firewx_cat, std::ptrdiff_t N) {
+    NFDRS_PROFILE_SCOPE("meteogram temperature_and_humidity");
     if (ImPlot::BeginPlot("Air Temperature and Humidity")) {
         // We want a 24 hour clock
         ImPlot::GetStyle().Use24HourClock = true;
@@ -123,7 +192,7 @@ static void temperature_and_humidity(const double stime[], const double tmpc[],
         ImPlot::PushStyleVar(ImPlotStyleVar_LineWeight, 1);
         ImPlot::PushStyleColor(ImPlotCol_Line, color);
         ImPlot::SetAxes(ImAxis_X1, ImAxis_Y2);
-        ImPlot::PlotLine("RELH", stime, relh, N);
+        PlotMetLine("RELH", stime, relh, N);
         ImPlot::PopStyleColor();
         ImPlot::PopStyleVar();
 
@@ -133,7 +202,7 @@ static void temperature_and_humidity(const double stime[], const double tmpc[],
         ImPlot::PushStyleColor(ImPlotCol_Line, color);
         ImPlot::SetAxes(ImAxis_X1, ImAxis_Y1);
         // plot the line data
-        ImPlot::PlotLine("TAIR", stime, tmpc, N);
+        PlotMetLine("TAIR", stime, tmpc, N);
         ImPlot::PopStyleColor();
         ImPlot::PopStyleVar();
 
@@ -141,9 +210,12 @@ static void temperature_and_humidity(const double stime[], const double tmpc[],
     }
 }
 
-static void surface_winds(const double stime[], const double wspd[],
-                          const double wdir[], const double gust[],
-                          const int firewx_cat[], std::ptrdiff_t N) {
+static void surface_winds(const double stime[], const fw21::MetColumn& wspd,
+                          const fw21::MetColumn& wdir,
+                          const fw21::MetColumn& gust,
+                          const std::vector<fw21::FireCatSpan>& firewx_cat,
+                          std::ptrdiff_t N) {
+    NFDRS_PROFILE_SCOPE("meteogram surface_winds");
     if (ImPlot::BeginPlot("10m Winds")) {
         // We want a 24 hour clock
         ImPlot::GetStyle().Use24HourClock = true;
@@ -183,7 +255,7 @@ static void surface_winds(const double stime[], const double wspd[],
                                ImVec4(0.102, 0.537, 0.769, 1.0));
         ImPlot::SetAxes(ImAxis_X1, ImAxis_Y1);
         // plot the line data
-        ImPlot::PlotShaded("WMAX", stime, gust, wspd, N);
+        PlotMetShaded("WMAX", stime, gust, &wspd, N);
         ImPlot::PopStyleColor();
         ImPlot::PopStyleVar();
 
@@ -192,7 +264,7 @@ static void surface_winds(const double stime[], const double wspd[],
         ImPlot::PushStyleColor(ImPlotCol_Fill, ImVec4(0.04, 0.254, 0.368, 1.0));
         ImPlot::SetAxes(ImAxis_X1, ImAxis_Y1);
         // plot the line data
-        ImPlot::PlotShaded("WSPD", stime, wspd, N, -INFINITY);
+        PlotMetShaded("WSPD", stime, wspd, nullptr, N);
         ImPlot::PopStyleColor();
         ImPlot::PopStyleVar();
 
@@ -201,17 +273,17 @@ static void surface_winds(const double stime[], const double wspd[],
         ImPlot::SetNextMarkerStyle(ImPlotMarker_Square, 2,
                                    ImPlot::GetColormapColor(1), IMPLOT_AUTO,
                                    ImPlot::GetColormapColor(1));
-        ImPlot::PlotScatter("WDIR", stime, wdir, N);
+        PlotMetScatter("WDIR", stime, wdir, N);
 
         ImPlot::EndPlot();
     }
 }
 
-static void solar_radiation_and_precip(const double stime[],
-                                       const double srad[],
-                                       const double precip[],
-                                       const int firewx_cat[],
-                                       std::ptrdiff_t N) {
+static void solar_radiation_and_precip(
+    const double stime[], const fw21::MetColumn& srad,
+    const fw21::MetColumn& precip,
+    const std::vector<fw21::FireCatSpan>& firewx_cat, std::ptrdiff_t N) {
+    NFDRS_PROFILE_SCOPE("meteogram solar_radiation_and_precip");
     if (ImPlot::BeginPlot("Solar Radiation and Precipitation")) {
         // We want a 24 hour clock
         ImPlot::GetStyle().Use24HourClock = true;
@@ -249,7 +321,7 @@ static void solar_radiation_and_precip(const double stime[],
         ImPlot::PushStyleColor(ImPlotCol_Fill, ImVec4(1, 0.867, 0.325, 1.0));
         ImPlot::SetAxes(ImAxis_X1, ImAxis_Y1);
         // plot the line data
-        ImPlot::PlotShaded("SRAD", stime, srad, N, -INFINITY);
+        PlotMetShaded("SRAD", stime, srad, nullptr, N);
         ImPlot::PopStyleColor();
         ImPlot::PopStyleVar();
 
@@ -258,7 +330,7 @@ static void solar_radiation_and_precip(const double stime[],
         ImPlot::PushStyleVar(ImPlotStyleVar_FillAlpha, 0.5f);
         ImPlot::PushStyleColor(ImPlotCol_Fill, rain_color);
         ImPlot::SetAxes(ImAxis_X1, ImAxis_Y2);
-        ImPlot::PlotBars("RAIN", stime, precip, N, 60 * 60);
+        PlotMetBars("RAIN", stime, precip, N, 60 * 60);
         ImPlot::PopStyleColor();
         ImPlot::PopStyleVar();
 
@@ -266,11 +338,24 @@ static void solar_radiation_and_precip(const double stime[],
     }
 }
 
+// Rows of a runner's outputs to draw: those computed so far, but no more
+// than the N rows on the time axis
+template <typename Runner>
+static int plot_rows(const Runner& runner, std::ptrdiff_t N) {
+    return static_cast<int>(std::min(N, runner.valid_rows()));
+}
+
 static void dead_fuel(const double stime[], const DeadFuelModelRunner& dfm_1h,
                       const DeadFuelModelRunner& dfm_10h,
                       const DeadFuelModelRunner& dfm_100h,
                       const DeadFuelModelRunner& dfm_1000h, std::ptrdiff_t N) {
+    NFDRS_PROFILE_SCOPE("meteogram dead_fuel");
     if (ImPlot::BeginPlot("Dead Fuels")) {
+        // Runs in progress are drawn up to their last computed row
+        const int n_1h = plot_rows(dfm_1h, N);
+        const int n_10h = plot_rows(dfm_10h, N);
+        const int n_100h = plot_rows(dfm_100h, N);
+        const int n_1000h = plot_rows(dfm_1000h, N);
         // We want a 24 hour clock
         ImPlot::GetStyle().Use24HourClock = true;
         // Set up our plot axes and constraints
@@ -301,29 +386,40 @@ static void dead_fuel(const double stime[], const DeadFuelModelRunner& dfm_1h,
         // Plot the Relative Humidity
         ImPlot::PushStyleVar(ImPlotStyleVar_LineWeight, 1);
         ImPlot::SetAxes(ImAxis_X1, ImAxis_Y2);
-        if (dfm_1h.finished) {
+        // Ensemble envelopes go underneath the single runs
+        PlotEnvelope("1h ens", stime, dfm_1h.ensemble,
+                     ImPlot::SampleColormap(0.95));
+        PlotEnvelope("10h ens", stime, dfm_10h.ensemble,
+                     ImPlot::SampleColormap(0.85));
+        PlotEnvelope("100h ens", stime, dfm_100h.ensemble,
+                     ImPlot::SampleColormap(0.8));
+        PlotEnvelope("1000h ens", stime, dfm_1000h.ensemble,
+                     ImPlot::SampleColormap(0.75));
+        if (n_1h > 0) {
             ImPlot::PushStyleColor(ImPlotCol_Line,
                                    ImPlot::SampleColormap(0.95));
-            ImPlot::PlotLine("1h fm", stime, dfm_1h.radial_moisture.get(), N);
+            ImPlot::PlotLine("1h fm", stime, dfm_1h.radial_moisture.data(),
+                             n_1h);
             ImPlot::PopStyleColor();
         }
-        if (dfm_10h.finished) {
+        if (n_10h > 0) {
             ImPlot::PushStyleColor(ImPlotCol_Line,
                                    ImPlot::SampleColormap(0.85));
-            ImPlot::PlotLine("10h fm", stime, dfm_10h.radial_moisture.get(), N);
+            ImPlot::PlotLine("10h fm", stime, dfm_10h.radial_moisture.data(),
+                             n_10h);
             ImPlot::PopStyleColor();
         }
-        if (dfm_100h.finished) {
+        if (n_100h > 0) {
             ImPlot::PushStyleColor(ImPlotCol_Line, ImPlot::SampleColormap(0.8));
-            ImPlot::PlotLine("100h fm", stime, dfm_100h.radial_moisture.get(),
-                             N);
+            ImPlot::PlotLine("100h fm", stime, dfm_100h.radial_moisture.data(),
+                             n_100h);
             ImPlot::PopStyleColor();
         }
-        if (dfm_1000h.finished) {
+        if (n_1000h > 0) {
             ImPlot::PushStyleColor(ImPlotCol_Line,
                                    ImPlot::SampleColormap(0.75));
-            ImPlot::PlotLine("1000h fm", stime, dfm_1000h.radial_moisture.get(),
-                             N);
+            ImPlot::PlotLine("1000h fm", stime,
+                             dfm_1000h.radial_moisture.data(), n_1000h);
             ImPlot::PopStyleColor();
         }
         ImPlot::PopStyleVar();
@@ -334,28 +430,92 @@ static void dead_fuel(const double stime[], const DeadFuelModelRunner& dfm_1h,
         ImPlot::PushColormap(cmap);
         ImPlot::PushStyleVar(ImPlotStyleVar_LineWeight, 1);
         ImPlot::SetAxes(ImAxis_X1, ImAxis_Y1);
-        if (dfm_1h.finished) {
+        if (n_1h > 0) {
             ImPlot::PushStyleColor(ImPlotCol_Line, ImPlot::SampleColormap(.2));
-            ImPlot::PlotLine("1h ft", stime, dfm_1h.fuel_temperature.get(), N);
+            ImPlot::PlotLine("1h ft", stime, dfm_1h.fuel_temperature.data(),
+                             n_1h);
             ImPlot::PopStyleColor();
         }
-        if (dfm_10h.finished) {
+        if (n_10h > 0) {
             ImPlot::PushStyleColor(ImPlotCol_Line, ImPlot::SampleColormap(.15));
-            ImPlot::PlotLine("10h ft", stime, dfm_10h.fuel_temperature.get(),
-                             N);
+            ImPlot::PlotLine("10h ft", stime, dfm_10h.fuel_temperature.data(),
+                             n_10h);
             ImPlot::PopStyleColor();
         }
-        if (dfm_100h.finished) {
+        if (n_100h > 0) {
             ImPlot::PushStyleColor(ImPlotCol_Line, ImPlot::SampleColormap(.1));
-            ImPlot::PlotLine("100h ft", stime, dfm_100h.fuel_temperature.get(),
-                             N);
+            ImPlot::PlotLine("100h ft", stime, dfm_100h.fuel_temperature.data(),
+                             n_100h);
             ImPlot::PopStyleColor();
         }
-        if (dfm_1000h.finished) {
+        if (n_1000h > 0) {
             ImPlot::PushStyleColor(ImPlotCol_Line,
                                    ImPlot::SampleColormap(0.05));
             ImPlot::PlotLine("1000h ft", stime,
-                             dfm_1000h.fuel_temperature.get(), N);
+                             dfm_1000h.fuel_temperature.data(), n_1000h);
+            ImPlot::PopStyleColor();
+        }
+        ImPlot::PopStyleVar();
+        ImPlot::PopColormap();
+
+        ImPlot::EndPlot();
+    }
+}
+
+static void live_fuel(const double stime[], const LiveFuelModelRunner& lfm_herb,
+                      const LiveFuelModelRunner& lfm_woody, std::ptrdiff_t N) {
+    NFDRS_PROFILE_SCOPE("meteogram live_fuel");
+    if (ImPlot::BeginPlot("Live Fuels")) {
+        const int n_herb = plot_rows(lfm_herb, N);
+        const int n_woody = plot_rows(lfm_woody, N);
+        // We want a 24 hour clock
+        ImPlot::GetStyle().Use24HourClock = true;
+        // Set up our plot axes and constraints
+        ImPlot::SetupAxes("Local Time", "Moisture (%)");
+        ImPlot::SetupAxis(ImAxis_X1, "", ImPlotAxisFlags_NoLabel);
+        ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Time);
+        ImPlot::SetupAxesLimits(stime[0], stime[N - 1], 0, 275);
+
+        // X-axis constraints
+        ImPlot::SetupAxisLimitsConstraints(ImAxis_X1, stime[0], stime[N - 1]);
+        ImPlot::SetupAxisZoomConstraints(ImAxis_X1, 60 * 60 * 48,
+                                         stime[N - 1] - stime[0]);
+
+        // Y-axis constraints
+        ImPlot::SetupAxisLimitsConstraints(ImAxis_Y1, 0, 300);
+        ImPlot::SetupAxisZoomConstraints(ImAxis_Y1, 10, 300);
+
+        // Set up a shared Y axis for the Growing Season Index
+        ImPlot::SetupAxis(ImAxis_Y2, "Growing Season Index",
+                          ImPlotAxisFlags_AuxDefault);
+        ImPlot::SetupAxisLimits(ImAxis_Y2, 0, 1);
+        ImPlot::SetupAxisLimitsConstraints(ImAxis_Y2, 0, 1);
+        ImPlot::SetupAxisZoomConstraints(ImAxis_Y2, 0.1, 1);
+
+        ImPlotColormap cmap = ImPlotColormap_BrBG;
+        ImPlot::PushColormap(cmap);
+        ImPlot::PushStyleVar(ImPlotStyleVar_LineWeight, 1);
+        // Plot the averaged Growing Season Index
+        ImPlot::SetAxes(ImAxis_X1, ImAxis_Y2);
+        if (n_herb > 0) {
+            ImPlot::PushStyleColor(ImPlotCol_Line, ImPlot::SampleColormap(0.5));
+            ImPlot::PlotLine("GSI", stime,
+                             lfm_herb.growing_season_index.data(), n_herb);
+            ImPlot::PopStyleColor();
+        }
+        // Plot the moisture contents
+        ImPlot::SetAxes(ImAxis_X1, ImAxis_Y1);
+        if (n_herb > 0) {
+            ImPlot::PushStyleColor(ImPlotCol_Line,
+                                   ImPlot::SampleColormap(0.85));
+            ImPlot::PlotLine("Herb fm", stime, lfm_herb.moisture.data(),
+                             n_herb);
+            ImPlot::PopStyleColor();
+        }
+        if (n_woody > 0) {
+            ImPlot::PushStyleColor(ImPlotCol_Line, ImPlot::SampleColormap(.1));
+            ImPlot::PlotLine("Woody fm", stime, lfm_woody.moisture.data(),
+                             n_woody);
             ImPlot::PopStyleColor();
         }
         ImPlot::PopStyleVar();
@@ -365,13 +525,90 @@ static void dead_fuel(const double stime[], const DeadFuelModelRunner& dfm_1h,
     }
 }
 
+static void fire_danger(const double stime[], const NFDRSModelRunner& indices,
+                        std::ptrdiff_t N) {
+    NFDRS_PROFILE_SCOPE("meteogram fire_danger");
+    if (ImPlot::BeginPlot("Fire Danger")) {
+        // We want a 24 hour clock
+        ImPlot::GetStyle().Use24HourClock = true;
+        // Set up our plot axes and constraints
+        ImPlot::SetupAxes("Local Time", "ERC, BI");
+        ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Time);
+        ImPlot::SetupAxesLimits(stime[0], stime[N - 1], 0, 100);
+
+        // X-axis constraints
+        ImPlot::SetupAxisLimitsConstraints(ImAxis_X1, stime[0], stime[N - 1]);
+        ImPlot::SetupAxisZoomConstraints(ImAxis_X1, 60 * 60 * 48,
+                                         stime[N - 1] - stime[0]);
+
+        // Y-axis constraints
+        ImPlot::SetupAxisLimitsConstraints(ImAxis_Y1, 0, 500);
+        ImPlot::SetupAxisZoomConstraints(ImAxis_Y1, 10, 500);
+
+        // Set up a shared Y axis for the ignition and spread components
+        ImPlot::SetupAxis(ImAxis_Y2, "IC, SC", ImPlotAxisFlags_AuxDefault);
+        ImPlot::SetupAxisLimits(ImAxis_Y2, 0, 100);
+        ImPlot::SetupAxisLimitsConstraints(ImAxis_Y2, 0, 500);
+        ImPlot::SetupAxisZoomConstraints(ImAxis_Y2, 10, 500);
+
+        const int n_rows = plot_rows(indices, N);
+        if (n_rows > 0) {
+            // The daily indices are appended as the run goes, so they are
+            // only drawn once it is complete
+            const int n_days =
+                indices.finished()
+                    ? static_cast<int>(indices.daily_time.size())
+                    : 0;
+            ImPlotColormap cmap = ImPlotColormap_Spectral;
+            ImPlot::PushColormap(cmap);
+            ImPlot::PushStyleVar(ImPlotStyleVar_LineWeight, 1);
+            ImPlot::SetAxes(ImAxis_X1, ImAxis_Y1);
+            ImPlot::PushStyleColor(ImPlotCol_Line, ImPlot::SampleColormap(0.1));
+            ImPlot::PlotLine("ERC", stime, indices.energy_release.data(),
+                             n_rows);
+            ImPlot::PlotScatter("Daily ERC", indices.daily_time.data(),
+                                indices.daily_energy_release.data(), n_days);
+            ImPlot::PopStyleColor();
+            ImPlot::PushStyleColor(ImPlotCol_Line, ImPlot::SampleColormap(0.3));
+            ImPlot::PlotLine("BI", stime, indices.burning_index.data(),
+                             n_rows);
+            ImPlot::PlotScatter("Daily BI", indices.daily_time.data(),
+                                indices.daily_burning_index.data(), n_days);
+            ImPlot::PopStyleColor();
+
+            ImPlot::SetAxes(ImAxis_X1, ImAxis_Y2);
+            ImPlot::PushStyleColor(ImPlotCol_Line, ImPlot::SampleColormap(0.7));
+            ImPlot::PlotLine("IC", stime, indices.ignition_component.data(),
+                             n_rows);
+            ImPlot::PlotScatter("Daily IC", indices.daily_time.data(),
+                                indices.daily_ignition_component.data(),
+                                n_days);
+            ImPlot::PopStyleColor();
+            ImPlot::PushStyleColor(ImPlotCol_Line, ImPlot::SampleColormap(0.9));
+            ImPlot::PlotLine("SC", stime, indices.spread_component.data(),
+                             n_rows);
+            ImPlot::PlotScatter("Daily SC", indices.daily_time.data(),
+                                indices.daily_spread_component.data(), n_days);
+            ImPlot::PopStyleColor();
+            ImPlot::PopStyleVar();
+            ImPlot::PopColormap();
+        }
+
+        ImPlot::EndPlot();
+    }
+}
+
 void meteogram(const std::unique_ptr<fw21::FW21Timeseries>& ts_data,
                const DeadFuelModelRunner& dfm_1h,
                const DeadFuelModelRunner& dfm_10h,
                const DeadFuelModelRunner& dfm_100h,
                const DeadFuelModelRunner& dfm_1000h,
-               const ImVec2 resize_thresh) {
-    const ImVec2 window_size = ImGui::GetWindowSize();
+               const LiveFuelModelRunner& lfm_herb,
+               const LiveFuelModelRunner& lfm_woody,
+               const NFDRSModelRunner& indices,
+               [[maybe_unused]] const ImVec2 resize_thresh) {
+    NFDRS_PROFILE_SCOPE("meteogram");
+    [[maybe_unused]] const ImVec2 window_size = ImGui::GetWindowSize();
     ImVec2 plot_size = {-1, -1};
     int rows = 3;
     int cols = 2;
@@ -386,24 +623,22 @@ void meteogram(const std::unique_ptr<fw21::FW21Timeseries>& ts_data,
             ImPlotSubplotFlags_LinkAllX | ImPlotSubplotFlags_ColMajor)) {
         if (ts_data) {
             temperature_and_humidity(ts_data->date_time.data(),
-                                     ts_data->air_temperature.data(),
-                                     ts_data->relative_humidity.data(),
-                                     ts_data->spc_cat.data(), ts_data->NT);
-            surface_winds(ts_data->date_time.data(), ts_data->wind_speed.data(),
-                          ts_data->wind_direction.data(),
-                          ts_data->gust_speed.data(), ts_data->spc_cat.data(),
-                          ts_data->NT);
+                                     ts_data->air_temperature,
+                                     ts_data->relative_humidity,
+                                     ts_data->fire_cat_spans, ts_data->NT);
+            surface_winds(ts_data->date_time.data(), ts_data->wind_speed,
+                          ts_data->wind_direction, ts_data->gust_speed,
+                          ts_data->fire_cat_spans, ts_data->NT);
             solar_radiation_and_precip(ts_data->date_time.data(),
-                                       ts_data->solar_radiation.data(),
-                                       ts_data->precipitation.data(),
-                                       ts_data->spc_cat.data(), ts_data->NT);
+                                       ts_data->solar_radiation,
+                                       ts_data->precipitation,
+                                       ts_data->fire_cat_spans, ts_data->NT);
 
             dead_fuel(ts_data->date_time.data(), dfm_1h, dfm_10h, dfm_100h,
                       dfm_1000h, ts_data->NT);
-            dead_fuel(ts_data->date_time.data(), dfm_1h, dfm_10h, dfm_100h,
-                      dfm_1000h, ts_data->NT);
-            dead_fuel(ts_data->date_time.data(), dfm_1h, dfm_10h, dfm_100h,
-                      dfm_1000h, ts_data->NT);
+            live_fuel(ts_data->date_time.data(), lfm_herb, lfm_woody,
+                      ts_data->NT);
+            fire_danger(ts_data->date_time.data(), indices, ts_data->NT);
         }
 
         ImPlot::EndSubplots();
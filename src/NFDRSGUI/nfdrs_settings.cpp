@@ -1,20 +1,55 @@
 
 #include <NFDRSGUI/NFDRSGUI.h>
 
-/*#include "NFDRSGUI/ModelRunners.h"*/
+#include "NFDRSGUI/FW21Decoder.h"
+#include "NFDRSGUI/ModelRunners.h"
+#include <algorithm>
+#include <iterator>
+
 #include "imgui.h"
 
 namespace nfdrs {
 
-void nfdrs_settings(bool& enabled) {
+void nfdrs_settings(bool& enabled, NFDRSModelRunner& indices,
+                    DeadFuelModelRunner& dfm_1h,
+                    DeadFuelModelRunner& dfm_10h,
+                    DeadFuelModelRunner& dfm_100h,
+                    DeadFuelModelRunner& dfm_1000h,
+                    LiveFuelModelRunner& lfm_herb,
+                    LiveFuelModelRunner& lfm_woody,
+                    fw21::FW21Timeseries& data) {
     if (ImGui::Begin("NFDRS4 Settings", &enabled)) {
+        ImGui::PushItemWidth(ImGui::GetFontSize() * -15);
+        const NFDRSFuelModel& current =
+            nfdrs_fuel_models[indices.settings.fuel_model];
+        if (ImGui::BeginCombo("Fuel Model", current.description)) {
+            for (int model = 0; model < static_cast<int>(std::size(
+                                            nfdrs_fuel_models));
+                 ++model) {
+                const bool selected = (model == indices.settings.fuel_model);
+                if (ImGui::Selectable(nfdrs_fuel_models[model].description,
+                                      selected)) {
+                    indices.settings.fuel_model = model;
+                }
+                if (selected) ImGui::SetItemDefaultFocus();
+            }
+            ImGui::EndCombo();
+        }
+        ImGui::SliderInt("Slope Class", &indices.settings.slope_class, 1, 5);
+        ImGui::SliderInt("Observation Hour", &indices.settings.obs_hour, 0,
+                         23);
         if (ImGui::Button("Default")) {
+            indices.default_settings();
         }
         ImGui::SameLine();
+        // Also runs the fuel moisture models that have not finished
         if (ImGui::Button("Run")) {
+            indices.run(data, dfm_1h, dfm_10h, dfm_100h, dfm_1000h, lfm_herb,
+                        lfm_woody);
         }
         ImGui::SameLine();
-        ImGui::ProgressBar(0);
+        ImGui::ProgressBar(indices.progress());
+        ImGui::PopItemWidth();
     }
     ImGui::End();
 }
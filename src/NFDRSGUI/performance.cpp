@@ -0,0 +1,101 @@
+#include <NFDRSGUI/NFDRSGUI.h>
+#include <NFDRSGUI/Profiler.h>
+
+#include <cfloat>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten_browser_file.h>
+#endif
+
+#include "imgui.h"
+
+namespace nfdrs {
+
+#if NFDRSGUI_PROFILING
+// One row of the metrics table: the name, the latest sample and mean,
+// the rate of the latest sample and a histogram of the history
+static void metric_row(const Profiler::Metric& metric) {
+    ImGui::TableNextRow();
+    ImGui::TableNextColumn();
+    ImGui::TextUnformatted(metric.name.c_str());
+    ImGui::TableNextColumn();
+    const char* format = metric.is_timer ? "%.3f ms" : "%.0f";
+    ImGui::Text(format, metric.last);
+    ImGui::TableNextColumn();
+    ImGui::Text(format, metric.mean());
+    ImGui::TableNextColumn();
+    if (!metric.work_unit.empty()) {
+        ImGui::Text("%.3g %s/s", metric.last_rate, metric.work_unit.c_str());
+    }
+    ImGui::TableNextColumn();
+    // the ring starts at next once it is full
+    ImGui::PushID(metric.name.c_str());
+    ImGui::PlotHistogram("##history", metric.history.data(),
+                         static_cast<int>(metric.history.size()),
+                         static_cast<int>(metric.next), nullptr, 0.0f,
+                         FLT_MAX, ImVec2(-1, ImGui::GetFontSize() * 2));
+    ImGui::PopID();
+}
+#endif
+
+void performance_window(bool& enabled) {
+    if (ImGui::Begin("Performance", &enabled)) {
+#if NFDRSGUI_PROFILING
+        Profiler& profiler = Profiler::instance();
+        if (ImGui::Button("Save JSON")) {
+#ifdef __EMSCRIPTEN__
+            const std::string json = profiler.to_json();
+            emscripten_browser_file::download("nfdrsgui_profile.json",
+                                              "application/json", json);
+#else
+            profiler.write_json("nfdrsgui_profile.json");
+#endif
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Clear")) profiler.clear();
+
+        // Timelines of every thread, for chrome://tracing or Perfetto
+        Tracer& tracer = Tracer::instance();
+        bool tracing = tracer.enabled();
+        if (ImGui::Checkbox("Record Trace", &tracing)) tracer.enable(tracing);
+        ImGui::SameLine();
+        if (ImGui::Button("Save Trace")) {
+#ifdef __EMSCRIPTEN__
+            const std::string json = tracer.to_json();
+            emscripten_browser_file::download("nfdrsgui_trace.json",
+                                              "application/json", json);
+#else
+            tracer.write_json("nfdrsgui_trace.json");
+#endif
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Clear Trace")) tracer.clear();
+
+        const std::vector<Profiler::Metric> metrics = profiler.metrics();
+        constexpr ImGuiTableFlags flags = ImGuiTableFlags_RowBg |
+                                          ImGuiTableFlags_BordersInnerV |
+                                          ImGuiTableFlags_Resizable;
+        if (ImGui::BeginTable("Metrics", 5, flags)) {
+            ImGui::TableSetupColumn("Name");
+            ImGui::TableSetupColumn("Last");
+            ImGui::TableSetupColumn("Mean");
+            ImGui::TableSetupColumn("Rate");
+            ImGui::TableSetupColumn("History",
+                                    ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableHeadersRow();
+            for (const auto& metric : metrics) metric_row(metric);
+            ImGui::EndTable();
+        }
+#else
+        ImGui::TextWrapped(
+            "Profiling is disabled. Rebuild with -DNFDRSGUI_PROFILING=ON to "
+            "record timings.");
+#endif
+    }
+    ImGui::End();
+}
+
+}  // namespace nfdrs
@@ -0,0 +1,252 @@
+// Throughput benchmark for the FW21 decoder.
+//
+// Decodes either a user supplied FW21 file or a synthetic hourly series
+// with both the current decoder and the original std::string/std::stod
+// based decoder, and reports the throughput of each in MB/s. The
+// timestamp decoders are also timed on their own in ns per call.
+//
+// usage: fw21_bench [n_rows | path/to/file.fw21] [n_repeats]
+#include <NFDRSGUI/FW21Decoder.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace legacy {
+
+// The original decoder, kept verbatim as the baseline to measure against.
+static std::time_t parse_datetime_to_unix_time(
+    const std::string& datetime_str) {
+    std::tm tm = {};
+    std::istringstream ss(datetime_str);
+    ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
+    if (ss.fail()) return -1;
+    std::time_t utc_time = std::mktime(&tm);
+    std::time_t loc_time = std::mktime(&tm);
+    if (utc_time == -1) return -1;
+    int hours_offset = 0, minutes_offset = 0;
+    char sign;
+    std::string timezone_str = datetime_str.substr(19);
+    std::istringstream timezone_stream(timezone_str);
+    timezone_stream >> sign >> hours_offset;
+    timezone_stream.ignore(1);
+    timezone_stream >> minutes_offset;
+    if (timezone_stream.fail()) return -1;
+    int offset_seconds = (hours_offset * 3600) + (minutes_offset * 60);
+    if (sign == '-') {
+        loc_time -= offset_seconds;
+    } else {
+        loc_time += offset_seconds;
+    }
+    return loc_time;
+}
+
+static void parse_row(fw21::FW21Timeseries& ts_data,
+                      const std::string_view buffer) {
+    std::size_t row_start = 0;
+    std::size_t row_end = 0;
+    std::ptrdiff_t row_idx = 0;
+    // Collected and pushed as one row, as the columns are no longer
+    // growable one by one
+    fw21::FW21Row row = {};
+    while ((row_end = buffer.find(',', row_start)) != std::string_view::npos) {
+        std::string element(buffer.substr(row_start, row_end - row_start));
+        size_t idx;
+        double val = std::nan("");
+        if ((row_idx > 1) && (row_idx != 9) && (element != "")) {
+            val = std::stod(element, &idx);
+        }
+        switch (row_idx) {
+            case 1:
+                row.date_time = static_cast<double>(
+                    parse_datetime_to_unix_time(element));
+                break;
+            case 2: row.air_temperature = val; break;
+            case 3: row.relative_humidity = val; break;
+            case 4: row.precipitation = val; break;
+            case 5: row.wind_speed = val; break;
+            case 6: row.wind_direction = val; break;
+            case 7: row.gust_speed = val; break;
+            case 8: row.gust_direction = val; break;
+            case 9:
+                row.snow_flag = (element != "") ? std::stoi(element, &idx) : 0;
+                break;
+            case 10: row.solar_radiation = val; break;
+        }
+        row_start = row_end + 1;
+        row_idx += 1;
+    }
+    if (row_idx > 1) ts_data.push_row(row);
+}
+
+static fw21::FW21Timeseries decode_fw21(std::string_view data_buffer) {
+    std::ptrdiff_t n_lines =
+        std::count(data_buffer.begin(), data_buffer.end(), '\n');
+    std::size_t n_chars = data_buffer.size();
+    fw21::FW21Timeseries ts_data = fw21::FW21Timeseries(n_lines);
+    for (std::ptrdiff_t line_idx = 0; line_idx < n_lines; ++line_idx) {
+        std::size_t row_end = data_buffer.find_first_of('\n');
+        if (row_end < n_chars) {
+            std::string_view row(data_buffer.substr(0, row_end));
+            if (line_idx > 0) parse_row(ts_data, row);
+            data_buffer.remove_prefix(row_end + 1);
+        }
+    }
+    parse_row(ts_data, data_buffer);
+    return ts_data;
+}
+
+}  // namespace legacy
+
+// Build an hourly FW21 series with a plausible diurnal cycle. Every row
+// carries a trailing delimiter so the legacy decoder sees all columns.
+static std::string synthetic_fw21(std::ptrdiff_t n_rows) {
+    std::string buffer =
+        "StationID,ObservationTime(yyyy-mm-ddThh:mm:ss-0x:00),"
+        "Temperature(F),RelativeHumidity(%),Precipitation(in),"
+        "WindSpeed(mph),WindAzimuth(degrees),GustSpeed(mph),"
+        "GustAzimuth(degrees),SnowFlag,SolarRadiation(W/m2)\n";
+    buffer.reserve(buffer.size() + n_rows * 72);
+
+    constexpr double pi = 3.14159265358979323846;
+    char line[256];
+    std::time_t t = 1577836800;  // 2020-01-01T00:00:00Z
+    for (std::ptrdiff_t i = 0; i < n_rows; ++i, t += 3600) {
+        std::tm tm_data;
+        gmtime_r(&t, &tm_data);
+        const double phase = 2.0 * pi * tm_data.tm_hour / 24.0;
+        const double tair = 55.0 - 15.0 * std::cos(phase);
+        const double relh = 50.0 + 30.0 * std::cos(phase);
+        const double srad = std::fmax(0.0, -900.0 * std::cos(phase));
+        std::snprintf(line, sizeof(line),
+                      "352126,%04d-%02d-%02dT%02d:00:00-07:00,%.0f,%.0f,%.2f,"
+                      "%d,%d,%d,%d,0,%.0f,\n",
+                      tm_data.tm_year + 1900, tm_data.tm_mon + 1,
+                      tm_data.tm_mday, tm_data.tm_hour, tair, relh,
+                      (i % 97 == 0) ? 0.05 : 0.0, 5 + int(i % 11),
+                      int((i * 37) % 360), 12 + int(i % 13),
+                      int((i * 41) % 360), srad);
+        buffer += line;
+    }
+    return buffer;
+}
+
+template <typename Decoder>
+static double measure(const char* label, const std::string& buffer,
+                      int n_repeats, Decoder decode) {
+    using Clock = std::chrono::steady_clock;
+    double best = 1e300;
+    std::ptrdiff_t n_rows = 0;
+    for (int rep = 0; rep < n_repeats; ++rep) {
+        auto start = Clock::now();
+        fw21::FW21Timeseries data = decode(buffer);
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+        best = std::min(best, elapsed.count());
+        n_rows = data.date_time.size();
+    }
+    const double mb_per_sec = (buffer.size() / 1.0e6) / best;
+    std::printf("%-8s %10td rows  %9.3f ms  %9.2f MB/s\n", label, n_rows,
+                best * 1.0e3, mb_per_sec);
+    return mb_per_sec;
+}
+
+template <typename Parser>
+static double measure_timestamps(const char* label,
+                                 const std::vector<std::string>& stamps,
+                                 Parser parse) {
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    std::time_t checksum = 0;
+    for (const std::string& stamp : stamps) checksum += parse(stamp);
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    const double ns_per_call = elapsed.count() / stamps.size();
+    std::printf("%-8s %10zu stamps %9.1f ns/call  (checksum %lld)\n", label,
+                stamps.size(), ns_per_call, static_cast<long long>(checksum));
+    return ns_per_call;
+}
+
+int main(int argc, char** argv) {
+    std::string buffer;
+    std::ptrdiff_t n_rows = 24 * 365 * 10;
+    if (argc > 1) {
+        char* end = nullptr;
+        long long requested = std::strtoll(argv[1], &end, 10);
+        if (*end == '\0') {
+            n_rows = requested;
+        } else {
+            std::ifstream infile(argv[1], std::ios::binary);
+            if (!infile) {
+                std::cerr << "Unable to open " << argv[1] << std::endl;
+                return 1;
+            }
+            std::ostringstream contents;
+            contents << infile.rdbuf();
+            buffer = contents.str();
+        }
+    }
+    if (buffer.empty()) buffer = synthetic_fw21(n_rows);
+    const int n_repeats = (argc > 2) ? std::atoi(argv[2]) : 5;
+
+    std::printf("decoding %.2f MB, best of %d\n", buffer.size() / 1.0e6,
+                n_repeats);
+    double baseline = measure("legacy", buffer, n_repeats, legacy::decode_fw21);
+    double current = measure("current", buffer, n_repeats,
+                             [](std::string_view data) {
+                                 return fw21::FW21Timeseries::decode_fw21(data);
+                             });
+    std::printf("speedup  %.1fx\n", current / baseline);
+    double parallel = measure("parallel", buffer, n_repeats,
+                              [](std::string_view data) {
+                                  return fw21::FW21Timeseries::
+                                      decode_fw21_parallel(data);
+                              });
+    std::printf("speedup  %.1fx\n", parallel / baseline);
+
+    // memory held by the decoded series at each storage precision
+    const std::pair<const char*, fw21::Precision> precisions[] = {
+        {"float64", fw21::Precision::Float64},
+        {"float32", fw21::Precision::Float32},
+        {"scaled16", fw21::Precision::Scaled16}};
+    for (const auto& [name, precision] : precisions) {
+        fw21::FW21Timeseries data =
+            fw21::FW21Timeseries::decode_fw21(buffer, precision);
+        std::printf("%-9s %8.2f MB\n", name, data.memory_usage() / 1.0e6);
+    }
+
+    // pull the timestamp column back out of the text for the
+    // per-timestamp comparison
+    std::vector<std::string> stamps;
+    std::size_t pos = buffer.find('\n');
+    while ((pos != std::string::npos) && (pos + 1 < buffer.size())) {
+        std::size_t first = buffer.find(',', pos + 1);
+        std::size_t second = buffer.find(',', first + 1);
+        if ((first == std::string::npos) || (second == std::string::npos)) {
+            break;
+        }
+        stamps.emplace_back(buffer, first + 1, second - first - 1);
+        pos = buffer.find('\n', second);
+    }
+    double legacy_ns = measure_timestamps(
+        "legacy", stamps, [](const std::string& stamp) {
+            return legacy::parse_datetime_to_unix_time(stamp);
+        });
+    double current_ns = measure_timestamps(
+        "current", stamps, [](const std::string& stamp) {
+            return fw21::parse_datetime_to_unix_time(stamp);
+        });
+    std::printf("speedup  %.1fx\n", legacy_ns / current_ns);
+
+    return 0;
+}
@@ -0,0 +1,527 @@
+// Benchmark suite over synthetic multi-station FW21 data.
+//
+// Generates years of hourly FW21 text for a number of stations, with
+// diurnal and seasonal temperature, humidity, wind and solar cycles and
+// random storms. It then times the decoders, the timestamp parser, the
+// fire weather categories, every dead fuel size class and, when built
+// with the GUI, drawing the meteogram into ImGui with no window or
+// renderer. Results are printed as a table and written as JSON so runs
+// of different versions can be compared.
+//
+// usage: nfdrs_bench [--years n] [--stations n] [--repeats n]
+//                    [--frames n] [-o results.json]
+#include <NFDRSGUI/FW21Decoder.h>
+#include <NFDRSGUI/ModelRunners.h>
+#include <NFDRSGUI/Profiler.h>
+#include <NFDRSGUI/Scheduler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if NFDRS_BENCH_METEOGRAM
+#include "imgui.h"
+#include "implot.h"
+
+namespace nfdrs {
+// From NFDRSGUI.h, which also pulls in GLFW and the ImGui backends
+void meteogram(const std::unique_ptr<fw21::FW21Timeseries>& met_data,
+               const DeadFuelModelRunner& dfm_1h,
+               const DeadFuelModelRunner& dfm_10h,
+               const DeadFuelModelRunner& dfm_100h,
+               const DeadFuelModelRunner& dfm_1000h,
+               const LiveFuelModelRunner& lfm_herb,
+               const LiveFuelModelRunner& lfm_woody,
+               const NFDRSModelRunner& indices,
+               const ImVec2 resize_thresh);
+}  // namespace nfdrs
+#endif
+
+// Set by CMake from git describe
+#ifndef NFDRSGUI_REVISION
+#define NFDRSGUI_REVISION "unknown"
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+constexpr double pi = 3.14159265358979323846;
+
+struct Options {
+    int n_years = 1;
+    int n_stations = 4;
+    int n_repeats = 3;
+    int n_frames = 120;
+    std::string out_path = "nfdrs_bench.json";
+};
+
+// One timed measurement: items of work (MB, rows, steps, ...) done in
+// seconds, the best of the repeats unless noted otherwise
+struct Result {
+    std::string name;
+    std::string unit;
+    double items;
+    double seconds;
+};
+
+// Where and how a synthetic station's weather is generated
+struct SyntheticStation {
+    std::string station_id;
+    double latitude;
+    // Local standard time, as in the FW21 timestamps
+    int utc_offset_hours;
+    // Annual mean air temperature, F
+    double mean_temperature;
+    std::uint32_t seed;
+};
+
+// Portable random numbers from a seeded mt19937, as the standard
+// distributions differ between library implementations
+class Random {
+    std::mt19937 m_engine;
+
+   public:
+    explicit Random(std::uint32_t seed) : m_engine(seed) {}
+    // Uniform in [0, 1)
+    double uniform() { return m_engine() / 4294967296.0; }
+    // Roughly standard normal, from the sum of 12 uniforms
+    double normal() {
+        double sum = 0.0;
+        for (int draw = 0; draw < 12; ++draw) sum += uniform();
+        return sum - 6.0;
+    }
+};
+
+std::vector<SyntheticStation> synthetic_stations(int n_stations) {
+    std::vector<SyntheticStation> stations;
+    for (int station = 0; station < n_stations; ++station) {
+        stations.push_back({std::to_string(100000 + 1111 * station),
+                            32.0 + static_cast<double>((station * 7) % 17),
+                            -5 - (station % 4),
+                            45.0 + static_cast<double>((station * 13) % 20),
+                            static_cast<std::uint32_t>(12345 + station)});
+    }
+    return stations;
+}
+
+double fahrenheit_to_celsius(double temperature) {
+    return (temperature - 32.0) * 5.0 / 9.0;
+}
+
+// Magnus saturation vapor pressure, up to a constant factor
+double saturation_vapor_pressure(double temperature_c) {
+    return std::exp(17.625 * temperature_c / (243.04 + temperature_c));
+}
+
+// Days since January 1st
+int day_of_year_from_civil(const fw21::CivilTime& civil) {
+    static constexpr int days_before_month[12] = {
+        0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+    const bool leap_year = ((civil.year % 4 == 0) && (civil.year % 100 != 0)) ||
+                           (civil.year % 400 == 0);
+    return days_before_month[civil.month - 1] + civil.day - 1 +
+           ((leap_year && (civil.month > 2)) ? 1 : 0);
+}
+
+// Shape of the diurnal temperature cycle in [-1, 1], coldest at 6 and
+// warmest at 15 local time
+double diurnal_temperature(int hour) {
+    if ((hour >= 6) && (hour < 15)) {
+        return -std::cos(pi * (hour - 6) / 9.0);
+    }
+    return std::cos(pi * ((hour + 9) % 24) / 15.0);
+}
+
+// n_years of hourly FW21 rows for station, starting 2020-01-01 local
+// time. Every row carries a trailing delimiter, as in exported files.
+std::string synthetic_fw21(const SyntheticStation& station, int n_years) {
+    std::string buffer =
+        "StationID,ObservationTime(yyyy-mm-ddThh:mm:ss-0x:00),"
+        "Temperature(F),RelativeHumidity(%),Precipitation(in),"
+        "WindSpeed(mph),WindAzimuth(degrees),GustSpeed(mph),"
+        "GustAzimuth(degrees),SnowFlag,SolarRadiation(W/m2)\n";
+    const std::ptrdiff_t n_rows =
+        static_cast<std::ptrdiff_t>(std::llround(n_years * 365.25 * 24.0));
+    buffer.reserve(buffer.size() + n_rows * 72);
+
+    Random random(station.seed);
+    const double latitude = station.latitude * pi / 180.0;
+    const std::time_t start = 1577836800 - station.utc_offset_hours * 3600;
+    // Weather that persists for days: a temperature anomaly, how dry
+    // the air is, the prevailing wind direction and the remaining
+    // hours of a storm
+    double anomaly = 0.0;
+    double dryness = 0.0;
+    double wind_direction = 225.0;
+    int storm_hours = 0;
+    char line[256];
+    for (std::ptrdiff_t row = 0; row < n_rows; ++row) {
+        // local standard time, from which the calendar fields are read
+        const std::time_t local_time =
+            start + 3600 * row + station.utc_offset_hours * 3600;
+        const fw21::CivilTime civil =
+            fw21::civil_from_unix_time(static_cast<double>(local_time));
+        const int day_of_year = day_of_year_from_civil(civil);
+        const int hour = civil.hour;
+        // -1 in early January, 1 in early July
+        const double season = -std::cos(2.0 * pi * (day_of_year + 10) / 365.25);
+
+        anomaly = 0.995 * anomaly + 0.35 * random.normal();
+        dryness = 0.997 * dryness + 0.08 * random.normal();
+        wind_direction += 4.0 * random.normal();
+
+        // storms are likelier on summer afternoons
+        if (storm_hours > 0) {
+            --storm_hours;
+        } else {
+            const double afternoon = ((hour >= 13) && (hour <= 19)) ? 1.0 : 0.0;
+            const double chance =
+                0.002 + 0.006 * afternoon * (season + 1.0) / 2.0;
+            if (random.uniform() < chance) {
+                storm_hours = 1 + static_cast<int>(random.uniform() * 6.0);
+            }
+        }
+        const bool raining = storm_hours > 0;
+
+        const double daily_range = 14.0 + 8.0 * (season + 1.0) / 2.0;
+        double air_temperature = station.mean_temperature + 20.0 * season +
+                                 anomaly +
+                                 0.5 * daily_range * diurnal_temperature(hour);
+        if (raining) air_temperature -= 6.0;
+
+        // dew point tracks the daily mean, drier in summer
+        const double depression =
+            std::max(1.0, 12.0 + 8.0 * season + 6.0 * dryness +
+                              2.0 * random.normal());
+        const double dew_point = std::min(
+            air_temperature, station.mean_temperature + 20.0 * season +
+                                 anomaly - depression);
+        double relative_humidity =
+            100.0 *
+            saturation_vapor_pressure(fahrenheit_to_celsius(dew_point)) /
+            saturation_vapor_pressure(fahrenheit_to_celsius(air_temperature));
+        if (raining) relative_humidity = 90.0 + 10.0 * random.uniform();
+        relative_humidity = std::clamp(relative_humidity, 5.0, 100.0);
+
+        // winds pick up through the afternoon
+        const double mixing =
+            ((hour >= 9) && (hour <= 21)) ? std::sin(pi * (hour - 9) / 12.0)
+                                          : 0.0;
+        const double wind_speed =
+            std::max(0.0, 4.0 + 8.0 * mixing + 2.0 * random.normal() +
+                              (raining ? 6.0 : 0.0));
+        const double gust_speed =
+            wind_speed * (1.3 + 0.3 * random.uniform()) + 2.0;
+        wind_direction = std::fmod(wind_direction + 360.0, 360.0);
+
+        // clear sky radiation from the sun's elevation, dimmed by storms
+        const double declination =
+            23.44 * pi / 180.0 *
+            std::sin(2.0 * pi * (284 + day_of_year) / 365.0);
+        const double hour_angle = 15.0 * pi / 180.0 * (hour + 0.5 - 12.0);
+        const double sin_elevation =
+            std::sin(latitude) * std::sin(declination) +
+            std::cos(latitude) * std::cos(declination) * std::cos(hour_angle);
+        const double solar_radiation =
+            (sin_elevation > 0.0)
+                ? 1000.0 * std::pow(sin_elevation, 1.15) * (raining ? 0.3 : 1.0)
+                : 0.0;
+
+        const double precipitation =
+            raining ? 0.01 + 0.15 * random.uniform() : 0.0;
+        const int snow_flag = (raining && (air_temperature < 32.0)) ? 1 : 0;
+
+        std::snprintf(
+            line, sizeof(line),
+            "%s,%04d-%02d-%02dT%02d:00:00%+03d:00,%.0f,%.0f,%.2f,%.0f,%.0f,"
+            "%.0f,%.0f,%d,%.0f,\n",
+            station.station_id.c_str(), civil.year, civil.month, civil.day,
+            hour, station.utc_offset_hours, air_temperature,
+            relative_humidity, precipitation, wind_speed, wind_direction,
+            gust_speed, std::fmod(wind_direction + 20.0, 360.0), snow_flag,
+            solar_radiation);
+        buffer += line;
+    }
+    return buffer;
+}
+
+bool parse_args(int argc, char** argv, Options& options) {
+    for (int arg = 1; arg < argc; ++arg) {
+        const std::string_view flag = argv[arg];
+        if (arg + 1 >= argc) return false;
+        if (flag == "--years") {
+            options.n_years = std::atoi(argv[++arg]);
+        } else if (flag == "--stations") {
+            options.n_stations = std::atoi(argv[++arg]);
+        } else if (flag == "--repeats") {
+            options.n_repeats = std::atoi(argv[++arg]);
+        } else if (flag == "--frames") {
+            options.n_frames = std::atoi(argv[++arg]);
+        } else if (flag == "-o") {
+            options.out_path = argv[++arg];
+        } else {
+            return false;
+        }
+    }
+    return (options.n_years > 0) && (options.n_stations > 0) &&
+           (options.n_repeats > 0) && (options.n_frames >= 0);
+}
+
+// Best of n_repeats calls of body, in seconds
+template <typename Body>
+double best_of(int n_repeats, Body body) {
+    double best = 1e300;
+    for (int repeat = 0; repeat < n_repeats; ++repeat) {
+        const auto start = Clock::now();
+        body();
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+// The timestamp column of every row of an FW21 buffer
+void collect_timestamps(const std::string& buffer,
+                        std::vector<std::string>& stamps) {
+    std::size_t pos = buffer.find('\n');
+    while ((pos != std::string::npos) && (pos + 1 < buffer.size())) {
+        const std::size_t first = buffer.find(',', pos + 1);
+        const std::size_t second = buffer.find(',', first + 1);
+        if ((first == std::string::npos) || (second == std::string::npos)) {
+            break;
+        }
+        stamps.emplace_back(buffer, first + 1, second - first - 1);
+        pos = buffer.find('\n', second);
+    }
+}
+
+#if NFDRS_BENCH_METEOGRAM
+// Draw the meteogram of one station's FW21 buffer into ImGui for
+// n_frames frames. No platform or renderer backend is attached: ImGui
+// and ImPlot build their draw lists, which are then dropped. Returns
+// the total seconds.
+double draw_meteogram(const std::string& buffer, int n_frames) {
+    auto met_data = std::make_unique<fw21::FW21Timeseries>(
+        fw21::FW21Timeseries::decode_fw21(buffer));
+    std::vector<std::unique_ptr<nfdrs::DeadFuelModelRunner>> dead_fuels;
+    for (const auto& fuel_class : nfdrs::dead_fuel_classes) {
+        dead_fuels.push_back(std::make_unique<nfdrs::DeadFuelModelRunner>(
+            fuel_class.radius, fuel_class.name, *met_data));
+    }
+    nfdrs::LiveFuelModelRunner herb(nfdrs::LiveFuelType::Herbaceous,
+                                    "Herbaceous", *met_data);
+    nfdrs::LiveFuelModelRunner woody(nfdrs::LiveFuelType::Woody, "Woody",
+                                     *met_data);
+    // Runs the fuel moisture models too
+    nfdrs::NFDRSModelRunner indices(*met_data);
+    indices.run(*met_data, *dead_fuels[0], *dead_fuels[1], *dead_fuels[2],
+                *dead_fuels[3], herb, woody);
+    indices.wait();
+
+    ImGui::CreateContext();
+    ImPlot::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.DisplaySize = ImVec2(1600.0f, 900.0f);
+    io.DeltaTime = 1.0f / 60.0f;
+    io.Fonts->Build();
+
+    double seconds = 0.0;
+    for (int frame = 0; frame < n_frames; ++frame) {
+        const auto start = Clock::now();
+        ImGui::NewFrame();
+        ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+        ImGui::SetNextWindowSize(io.DisplaySize);
+        if (ImGui::Begin("Station Meteogram")) {
+            nfdrs::meteogram(met_data, *dead_fuels[0], *dead_fuels[1],
+                             *dead_fuels[2], *dead_fuels[3], herb, woody,
+                             indices, ImVec2(1200.0f, 512.0f));
+        }
+        ImGui::End();
+        ImGui::Render();
+        const std::chrono::duration<double> elapsed = Clock::now() - start;
+        seconds += elapsed.count();
+    }
+
+    ImPlot::DestroyContext();
+    ImGui::DestroyContext();
+    return seconds;
+}
+#endif
+
+void append_json_string(std::string& out, std::string_view text) {
+    out += '"';
+    for (char c : text) {
+        if ((c == '"') || (c == '\\')) out += '\\';
+        out += c;
+    }
+    out += '"';
+}
+
+std::string results_json(const Options& options, unsigned n_threads,
+                         const std::vector<Result>& results) {
+    char number[64];
+    std::string out = "{\n  \"benchmark\": \"nfdrs_bench\",\n  \"revision\": ";
+    append_json_string(out, NFDRSGUI_REVISION);
+    std::snprintf(number, sizeof(number), "%lld",
+                  static_cast<long long>(std::time(nullptr)));
+    out += ",\n  \"time\": ";
+    out += number;
+    std::snprintf(number, sizeof(number),
+                  ",\n  \"years\": %d,\n  \"stations\": %d,\n", options.n_years,
+                  options.n_stations);
+    out += number;
+    std::snprintf(number, sizeof(number),
+                  "  \"repeats\": %d,\n  \"threads\": %u,\n", options.n_repeats,
+                  n_threads);
+    out += number;
+    out += "  \"results\": [";
+    for (std::size_t idx = 0; idx < results.size(); ++idx) {
+        const Result& result = results[idx];
+        out += (idx > 0) ? ",\n    {\"name\": " : "\n    {\"name\": ";
+        append_json_string(out, result.name);
+        out += ", \"unit\": ";
+        append_json_string(out, result.unit);
+        std::snprintf(number, sizeof(number), ", \"items\": %.6g",
+                      result.items);
+        out += number;
+        std::snprintf(number, sizeof(number), ", \"seconds\": %.6g",
+                      result.seconds);
+        out += number;
+        std::snprintf(number, sizeof(number), ", \"per_second\": %.6g}",
+                      (result.seconds > 0.0) ? result.items / result.seconds
+                                             : 0.0);
+        out += number;
+    }
+    out += "\n  ]\n}\n";
+    return out;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse_args(argc, argv, options)) {
+        std::cerr << "usage: nfdrs_bench [--years n] [--stations n] "
+                     "[--repeats n] [--frames n] [-o results.json]"
+                  << std::endl;
+        return 1;
+    }
+    const unsigned n_threads = nfdrs::Scheduler::instance().size();
+
+    std::vector<std::string> buffers;
+    double total_mb = 0.0;
+    for (const auto& station : synthetic_stations(options.n_stations)) {
+        buffers.push_back(synthetic_fw21(station, options.n_years));
+        total_mb += buffers.back().size() / 1.0e6;
+    }
+    std::printf("%d stations, %d years, %.2f MB, %u threads, best of %d\n",
+                options.n_stations, options.n_years, total_mb, n_threads,
+                options.n_repeats);
+
+    std::vector<Result> results;
+    auto report = [&results](Result result) {
+        const double rate =
+            (result.seconds > 0.0) ? result.items / result.seconds : 0.0;
+        std::printf("%-28s %12.3f ms %14.4g %s/s\n", result.name.c_str(),
+                    result.seconds * 1.0e3, rate, result.unit.c_str());
+        results.push_back(std::move(result));
+    };
+
+    std::vector<fw21::FW21Timeseries> series;
+    for (const std::string& buffer : buffers) {
+        series.push_back(fw21::FW21Timeseries::decode_fw21(buffer));
+    }
+    double n_rows = 0.0;
+    for (const auto& data : series) n_rows += static_cast<double>(data.NT);
+
+    report({"decode_fw21", "MB", total_mb,
+            best_of(options.n_repeats, [&buffers]() {
+                for (const std::string& buffer : buffers) {
+                    fw21::FW21Timeseries::decode_fw21(buffer);
+                }
+            })});
+    report({"decode_fw21_parallel", "MB", total_mb,
+            best_of(options.n_repeats, [&buffers]() {
+                for (const std::string& buffer : buffers) {
+                    fw21::FW21Timeseries::decode_fw21_parallel(buffer);
+                }
+            })});
+
+    std::vector<std::string> stamps;
+    for (const std::string& buffer : buffers) {
+        collect_timestamps(buffer, stamps);
+    }
+    std::time_t checksum = 0;
+    report({"parse_datetime_to_unix_time", "stamps",
+            static_cast<double>(stamps.size()),
+            best_of(options.n_repeats, [&stamps, &checksum]() {
+                for (const std::string& stamp : stamps) {
+                    checksum += fw21::parse_datetime_to_unix_time(stamp);
+                }
+            })});
+
+    report({"calc_fire_cat", "rows", n_rows,
+            best_of(options.n_repeats, [&series]() {
+                for (auto& data : series) data.calc_fire_cat();
+            })});
+
+    // One size class at a time on this thread; the converted inputs
+    // are shared by every run, so they are built up front
+    for (const auto& data : series) data.model_inputs();
+    for (const auto& fuel_class : nfdrs::dead_fuel_classes) {
+        double best = 1e300;
+        for (int repeat = 0; repeat < options.n_repeats; ++repeat) {
+            double seconds = 0.0;
+            for (const auto& data : series) {
+                nfdrs::DeadFuelModelRunner runner(fuel_class.radius,
+                                                  fuel_class.name, data);
+                runner.apply_settings();
+                const auto start = Clock::now();
+                runner.calc_dfm(data, 0);
+                const std::chrono::duration<double> elapsed =
+                    Clock::now() - start;
+                seconds += elapsed.count();
+            }
+            best = std::min(best, seconds);
+        }
+        report({std::string("calc_dfm ") + fuel_class.name, "steps", n_rows,
+                best});
+    }
+
+#if NFDRS_BENCH_METEOGRAM
+    if (options.n_frames > 0) {
+        // the mean frame, not the best, as frames differ
+        report({"meteogram", "frames", static_cast<double>(options.n_frames),
+                draw_meteogram(buffers.front(), options.n_frames)});
+        // and each subplot, if the profiling timers were built in
+        for (const auto& metric : nfdrs::Profiler::instance().metrics()) {
+            if (metric.name.rfind("meteogram ", 0) != 0) continue;
+            report({metric.name, "frames", static_cast<double>(metric.count),
+                    metric.total * 1.0e-3});
+        }
+    }
+#endif
+
+    std::ofstream file(options.out_path);
+    if (file) file << results_json(options, n_threads, results);
+    if (!file) {
+        std::cerr << "Could not write " << options.out_path << std::endl;
+        return 2;
+    }
+    std::printf("wrote %s (checksum %lld)\n", options.out_path.c_str(),
+                static_cast<long long>(checksum));
+    return 0;
+}
@@ -0,0 +1,20 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <cstdio>
+
+// Minimal assertion for the test programs: reports a failed condition
+// and counts it, so a test can report every failure before returning
+// check_failures as its exit status.
+inline int check_failures = 0;
+
+#define CHECK(condition)                                                  \
+    do {                                                                  \
+        if (!(condition)) {                                               \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__,   \
+                         __LINE__, #condition);                           \
+            ++check_failures;                                             \
+        }                                                                 \
+    } while (false)
+
+#endif
@@ -0,0 +1,87 @@
+// Resuming a dead fuel run from a daily snapshot reproduces a full run
+#include <NFDRSGUI/FW21Decoder.h>
+#include <NFDRSGUI/ModelRunners.h>
+
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "synthetic_fw21.h"
+
+namespace {
+
+bool same_outputs(const nfdrs::DeadFuelModelRunner& lhs,
+                  const nfdrs::DeadFuelModelRunner& rhs) {
+    if ((lhs.valid_rows() != rhs.valid_rows()) ||
+        (lhs.radial_moisture != rhs.radial_moisture) ||
+        (lhs.fuel_temperature != rhs.fuel_temperature)) {
+        return false;
+    }
+    return true;
+}
+
+// rerun_from resumes from the start of the day of the rerun row
+void rerun_matches_full_run() {
+    const fw21::FW21Timeseries data =
+        fw21::FW21Timeseries::decode_fw21(synthetic_fw21(24 * 20));
+    nfdrs::DeadFuelModelRunner full(2.0, "100-hour", data);
+    full.run(data);
+    full.wait();
+
+    // a result restored from the cache comes without snapshots
+    nfdrs::ResultCache::instance().clear();
+    nfdrs::DeadFuelModelRunner resumed(2.0, "100-hour", data);
+    resumed.run(data);
+    resumed.wait();
+    CHECK(resumed.snapshots.size() == resumed.snapshot_days);
+    for (std::ptrdiff_t row : {data.NT - 1, data.NT - 30, data.NT - 24 * 5}) {
+        // the rows from row on must be recomputed
+        for (std::ptrdiff_t i = row; i < data.NT; ++i) {
+            resumed.radial_moisture[i] = 0.0;
+            resumed.fuel_temperature[i] = 0.0;
+        }
+        const std::ptrdiff_t start = resumed.rerun_from(data, row);
+        resumed.wait();
+        CHECK((start > row - 24) && (start <= row));
+        CHECK(data.model_inputs().hour[start] == 0);
+        CHECK(same_outputs(full, resumed));
+    }
+
+    // without a snapshot that early, the run starts over
+    CHECK(resumed.rerun_from(data, 5) == 0);
+    resumed.wait();
+    CHECK(same_outputs(full, resumed));
+}
+
+// Follow mode: the last row was still being written when the file was
+// decoded, and is replaced once it is complete
+void replaced_row_matches_full_run() {
+    const std::string complete = synthetic_fw21(24 * 10 + 7);
+    const std::string partial = complete.substr(0, complete.size() - 30);
+    fw21::FW21Timeseries data = fw21::FW21Timeseries::decode_fw21(partial);
+    CHECK(data.partial_last_row);
+
+    nfdrs::ResultCache::instance().clear();
+    nfdrs::DeadFuelModelRunner follower(6.4, "1000-hour", data);
+    follower.run(data);
+    follower.wait();
+    const bool replaced = data.partial_last_row;
+    data.append_fw21(complete);
+    follower.extend(data, replaced);
+    follower.wait();
+
+    const fw21::FW21Timeseries reference =
+        fw21::FW21Timeseries::decode_fw21(complete);
+    nfdrs::DeadFuelModelRunner full(6.4, "1000-hour", reference);
+    full.run(reference);
+    full.wait();
+    CHECK(same_outputs(full, follower));
+}
+
+}  // namespace
+
+int main() {
+    rerun_matches_full_run();
+    replaced_row_matches_full_run();
+    return check_failures;
+}
@@ -0,0 +1,112 @@
+// The fire danger pipeline streaming rows from the fuel moisture runners
+// gives the indices of a run over finished runners, and holds fast
+// runners back to a bounded window ahead of the indices
+#include <NFDRSGUI/FW21Decoder.h>
+#include <NFDRSGUI/ModelRunners.h>
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "check.h"
+#include "synthetic_fw21.h"
+
+namespace {
+
+// The fuel moisture runners feeding the indices
+struct FuelRunners {
+    nfdrs::DeadFuelModelRunner dfm_1h, dfm_10h, dfm_100h, dfm_1000h;
+    nfdrs::LiveFuelModelRunner lfm_herb, lfm_woody;
+
+    explicit FuelRunners(const fw21::FW21Timeseries& data)
+        : dfm_1h(0.20, "1-hour", data),
+          dfm_10h(0.64, "10-hour", data),
+          dfm_100h(2.0, "100-hour", data),
+          dfm_1000h(6.40, "1000-hour", data),
+          lfm_herb(nfdrs::LiveFuelType::Herbaceous, "Herbaceous", data),
+          lfm_woody(nfdrs::LiveFuelType::Woody, "Woody", data) {}
+
+    void run_indices(nfdrs::NFDRSModelRunner& indices,
+                     const fw21::FW21Timeseries& data) {
+        indices.run(data, dfm_1h, dfm_10h, dfm_100h, dfm_1000h, lfm_herb,
+                    lfm_woody);
+    }
+
+    // Rows published by the runner furthest ahead
+    std::ptrdiff_t max_valid_rows() const {
+        std::ptrdiff_t rows = 0;
+        for (std::ptrdiff_t valid :
+             {dfm_1h.valid_rows(), dfm_10h.valid_rows(),
+              dfm_100h.valid_rows(), dfm_1000h.valid_rows(),
+              lfm_herb.valid_rows(), lfm_woody.valid_rows()}) {
+            if (valid > rows) rows = valid;
+        }
+        return rows;
+    }
+};
+
+// Bitwise, so that rows left NaN on both sides compare equal
+template <typename T>
+bool same_values(const std::vector<T>& lhs, const std::vector<T>& rhs) {
+    return (lhs.size() == rhs.size()) &&
+           (std::memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(T)) ==
+            0);
+}
+
+void pipeline_matches_finished_runners() {
+    const fw21::FW21Timeseries data =
+        fw21::FW21Timeseries::decode_fw21(synthetic_fw21(24 * 365));
+
+    // every fuel moisture run finished before the indices start
+    FuelRunners finished(data);
+    for (nfdrs::DeadFuelModelRunner* dfm :
+         {&finished.dfm_1h, &finished.dfm_10h, &finished.dfm_100h,
+          &finished.dfm_1000h}) {
+        dfm->run(data);
+        dfm->wait();
+    }
+    for (nfdrs::LiveFuelModelRunner* lfm :
+         {&finished.lfm_herb, &finished.lfm_woody}) {
+        lfm->run(data);
+        lfm->wait();
+    }
+    nfdrs::NFDRSModelRunner reference(data);
+    finished.run_indices(reference, data);
+    reference.wait();
+    CHECK(reference.finished());
+
+    // every run driven by the pipeline, none restored from the cache
+    nfdrs::ResultCache::instance().clear();
+    FuelRunners streamed(data);
+    nfdrs::NFDRSModelRunner indices(data);
+    streamed.run_indices(indices, data);
+    while (indices.running()) {
+        // a producer publishes at most one chunk once it has reached the
+        // window, and indices.valid_rows() only grows meanwhile
+        const std::ptrdiff_t produced = streamed.max_valid_rows();
+        const std::ptrdiff_t consumed = indices.valid_rows();
+        CHECK(produced - consumed <
+              nfdrs::NFDRSModelRunner::pipeline_window_rows +
+                  nfdrs::NFDRSModelRunner::pipeline_chunk_rows);
+    }
+    indices.wait();
+    CHECK(indices.finished());
+
+    // an index stage reading a row before it was published would have
+    // taken the zeros the outputs start with
+    CHECK(same_values(indices.inputs, reference.inputs));
+    CHECK(same_values(indices.energy_release, reference.energy_release));
+    CHECK(same_values(indices.burning_index, reference.burning_index));
+    CHECK(same_values(indices.ignition_component,
+                      reference.ignition_component));
+    CHECK(same_values(indices.spread_component, reference.spread_component));
+    CHECK(same_values(indices.daily_energy_release,
+                      reference.daily_energy_release));
+}
+
+}  // namespace
+
+int main() {
+    pipeline_matches_finished_runners();
+    return check_failures;
+}
@@ -0,0 +1,80 @@
+// append_fw21 on a source file that grows while it is being followed
+#include <NFDRSGUI/FW21Decoder.h>
+
+#include <cmath>
+#include <string>
+
+#include "check.h"
+
+namespace {
+
+const std::string header =
+    "StationID,ObservationTime(yyyy-mm-ddThh:mm:ss-0x:00),Temperature(F),"
+    "RelativeHumidity(%),Precipitation(in),WindSpeed(mph),"
+    "WindAzimuth(degrees),GustSpeed(mph),GustAzimuth(degrees),SnowFlag,"
+    "SolarRadiation(W/m2)\n";
+const std::string row_1 =
+    "352126,2020-01-01T00:00:00-07:00,40,80,0.05,5,0,12,0,0,0,\n";
+const std::string row_2 =
+    "352126,2020-01-01T01:00:00-07:00,41,79,0.00,6,37,13,41,0,0,\n";
+
+bool rows_valid(const fw21::FW21Timeseries& ts_data) {
+    for (std::ptrdiff_t row = 0; row < ts_data.NT; ++row) {
+        if ((ts_data.date_time[row] == -1.0) ||
+            (std::isnan(ts_data.air_temperature[row]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// A file that is empty, or whose header is still being written, when it
+// is first decoded
+void header_then_rows() {
+    for (const std::string& first :
+         {std::string(), header.substr(0, 20), header}) {
+        fw21::FW21Timeseries ts_data = fw21::FW21Timeseries::decode_fw21(first);
+        CHECK(ts_data.NT == 0);
+        CHECK(ts_data.header_consumed == (first == header));
+
+        // the rest of the header arrives on its own
+        CHECK(ts_data.append_fw21(header) == 0);
+        CHECK(ts_data.NT == 0);
+        CHECK(ts_data.header_consumed);
+
+        CHECK(ts_data.append_fw21(header + row_1) == 1);
+        CHECK(ts_data.append_fw21(header + row_1 + row_2) == 1);
+        CHECK(ts_data.NT == 2);
+        CHECK(rows_valid(ts_data));
+        CHECK(ts_data.consumed_bytes == (header + row_1 + row_2).size());
+        CHECK(ts_data.air_temperature[1] == 41.0);
+    }
+}
+
+// The header and rows arrive in one piece after an empty first read
+void header_and_rows_at_once() {
+    fw21::FW21Timeseries ts_data = fw21::FW21Timeseries::decode_fw21("");
+    CHECK(ts_data.append_fw21(header + row_1 + row_2) == 2);
+    CHECK(rows_valid(ts_data));
+}
+
+// A row still being written is replaced once its line is complete
+void partial_row() {
+    const std::string partial = header + row_1 + row_2.substr(0, 40);
+    fw21::FW21Timeseries ts_data = fw21::FW21Timeseries::decode_fw21(partial);
+    CHECK(ts_data.NT == 2);
+    CHECK(ts_data.partial_last_row);
+    CHECK(ts_data.append_fw21(header + row_1 + row_2) == 1);
+    CHECK(ts_data.NT == 2);
+    CHECK(!ts_data.partial_last_row);
+    CHECK(ts_data.relative_humidity[1] == 79.0);
+}
+
+}  // namespace
+
+int main() {
+    header_then_rows();
+    header_and_rows_at_once();
+    partial_row();
+    return check_failures;
+}
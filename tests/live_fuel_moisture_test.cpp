@@ -0,0 +1,106 @@
+// The Growing Season Index and live fuel moisture against the limits of
+// Jolly et al. (2005) and the NFDRS 2016 live fuel moisture ramps
+#include <NFDRSGUI/FW21Decoder.h>
+#include <NFDRSGUI/ModelInputs.h>
+#include <NFDRSGUI/ModelRunners.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "check.h"
+
+namespace {
+
+bool near(double value, double expected) {
+    return std::fabs(value - expected) < 1e-6;
+}
+
+// Relative humidity (fraction) giving a vapor pressure deficit of vpd
+// (Pa) at temperature (deg C)
+double humidity_for_deficit(double vpd, double temperature) {
+    const double saturation =
+        610.78 * std::exp(17.27 * temperature / (temperature + 237.3));
+    return 1.0 - vpd / saturation;
+}
+
+// Append n_hours rows of constant weather on year-month-day to inputs
+void add_hours(fw21::ModelInputs& inputs, int year, int month, int day,
+               int n_hours, double temperature, double humidity) {
+    for (int hour = 0; hour < n_hours; ++hour) {
+        inputs.year.push_back(static_cast<std::int16_t>(year));
+        inputs.month.push_back(static_cast<std::uint8_t>(month));
+        inputs.day.push_back(static_cast<std::uint8_t>(day));
+        inputs.hour.push_back(static_cast<std::uint8_t>(hour));
+        inputs.minute.push_back(0);
+        inputs.second.push_back(0);
+        inputs.air_temperature.push_back(temperature);
+        inputs.relative_humidity.push_back(humidity);
+        inputs.solar_radiation.push_back(0.0);
+        inputs.precipitation.push_back(0.0);
+        inputs.valid.push_back(1);
+        ++inputs.NT;
+    }
+}
+
+// GSI of one day of constant weather at latitude, read once the first
+// hour of the next day closes it
+double daily_gsi(double latitude, int month, int day, double temperature,
+                 double humidity) {
+    fw21::ModelInputs inputs;
+    add_hours(inputs, 2021, month, day, 24, temperature, humidity);
+    add_hours(inputs, 2021, month, day + 1, 1, temperature, humidity);
+    nfdrs::GrowingSeasonIndex gsi(latitude, 1);
+    for (std::ptrdiff_t i = 0; i < inputs.NT; ++i) gsi.update(inputs, i);
+    return gsi.average();
+}
+
+// Each index is 0 at or beyond its unfavourable limit, 1 at or beyond
+// its favourable one and linear in between: minimum temperature from
+// -2 to 5 deg C, vapor pressure deficit from 4100 to 900 Pa and
+// daylength from 10 to 11 hours
+void gsi_limits() {
+    // long, warm and saturated midsummer days
+    CHECK(near(daily_gsi(40.0, 6, 21, 10.0, 1.0), 1.0));
+    // under 10 hours of daylight at the winter solstice
+    CHECK(near(daily_gsi(40.0, 12, 21, 10.0, 1.0), 0.0));
+    // 12 hours of daylight all year at the equator
+    CHECK(near(daily_gsi(0.0, 12, 21, 10.0, 1.0), 1.0));
+    // midway along the minimum temperature ramp
+    CHECK(near(daily_gsi(40.0, 6, 21, 1.5, 1.0), 0.5));
+    CHECK(near(daily_gsi(40.0, 6, 21, -2.0, 1.0), 0.0));
+    // midway along the vapor pressure deficit ramp, and past its ends
+    CHECK(near(daily_gsi(40.0, 6, 21, 30.0, humidity_for_deficit(2500, 30)),
+               0.5));
+    CHECK(near(daily_gsi(40.0, 6, 21, 30.0, humidity_for_deficit(900, 30)),
+               1.0));
+    CHECK(near(daily_gsi(40.0, 6, 21, 30.0, humidity_for_deficit(4100, 30)),
+               0.0));
+}
+
+// The NFDRS 2016 defaults hold the minimum moisture up to a GSI of 0.5
+// and rise linearly to the maximum at 1: 30% to 250% for herbaceous and
+// 60% to 200% for woody fuels
+void moisture_ramps() {
+    const fw21::FW21Timeseries data;
+    nfdrs::LiveFuelModelRunner herb(nfdrs::LiveFuelType::Herbaceous,
+                                    "Herbaceous", data);
+    nfdrs::LiveFuelModelRunner woody(nfdrs::LiveFuelType::Woody, "Woody",
+                                     data);
+    CHECK(near(nfdrs::live_fuel_moisture(herb.settings, 0.2), 30.0));
+    CHECK(near(nfdrs::live_fuel_moisture(herb.settings, 0.5), 30.0));
+    CHECK(near(nfdrs::live_fuel_moisture(herb.settings, 0.75), 140.0));
+    CHECK(near(nfdrs::live_fuel_moisture(herb.settings, 1.0), 250.0));
+    CHECK(near(nfdrs::live_fuel_moisture(woody.settings, 0.2), 60.0));
+    CHECK(near(nfdrs::live_fuel_moisture(woody.settings, 0.75), 130.0));
+    CHECK(near(nfdrs::live_fuel_moisture(woody.settings, 1.0), 200.0));
+    CHECK(std::isnan(nfdrs::live_fuel_moisture(herb.settings, std::nan(""))));
+}
+
+}  // namespace
+
+int main() {
+    gsi_limits();
+    moisture_ramps();
+    return check_failures;
+}
@@ -0,0 +1,34 @@
+#ifndef SYNTHETIC_FW21_H
+#define SYNTHETIC_FW21_H
+
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <string>
+
+// FW21 rows for n_hours hours from 2020-01-01, with a diurnal cycle and
+// a shower every few days
+inline std::string synthetic_fw21(int n_hours) {
+    std::string buffer = "StationID,ObservationTime\n";
+    char row[160];
+    for (int hour = 0; hour < n_hours; ++hour) {
+        const std::time_t time = 1577836800 + 3600 * std::time_t(hour);
+        std::tm civil;
+        gmtime_r(&time, &civil);
+        const double phase = 2.0 * M_PI * (hour % 24) / 24.0;
+        std::snprintf(row, sizeof(row),
+                      "352126,%04d-%02d-%02dT%02d:00:00+00:00,%.1f,%.1f,"
+                      "%.2f,%.1f,180,%.1f,180,0,%.1f,\n",
+                      civil.tm_year + 1900, civil.tm_mon + 1, civil.tm_mday,
+                      civil.tm_hour, 55.0 - 15.0 * std::cos(phase),
+                      50.0 + 30.0 * std::cos(phase),
+                      (hour % 97 < 3) ? 0.05 : 0.0,
+                      8.0 + 4.0 * std::sin(phase),
+                      14.0 + 4.0 * std::sin(phase),
+                      std::fmax(0.0, -800.0 * std::cos(phase)));
+        buffer += row;
+    }
+    return buffer;
+}
+
+#endif